@@ -46,16 +46,23 @@
  * `file << ""` around as many times as there are arguments).
  *
  * `file` defaults to `std::cout`. `sep` defaults to `' '` (space character). `end` defaults to `'\n'` (newline
- * character). `flush` defaults to `false`.
+ * character). `flush` defaults to `false`. `prefix` defaults to `print_nothing`, and is otherwise printed before
+ * the arguments as if it were an extra first argument (So it is followed by `sep`).
  *
- * To set these 4 arguments, there are 4 static variables, called `file`, `sep`, `end` and `flush`.
+ * To set these 5 arguments, there are 5 static variables, called `file`, `sep`, `end`, `prefix` and `flush`.
  * Their `operator=` will return an object which will set the corresponding argument to the value it was set to.
  *
+ * `printer::timestamp` is meant to be used as a `prefix`. It prints the current time with a `strftime` format
+ * (Plus `%f` for fractions of a second), which is cached per thread so `strftime` is only called once a second:
+ *
+ *     print("Started", prefix=printer::timestamp("[%H:%M:%S.%3f]"));  // Prints "[12:34:56.789] Started\n"
+ *
  *
  * If you do not want these static variables in the global scope, define `PRINT_NO_GLOBALS` before including
- * this file. These variables are of type `printer::file_t`, `printer::sep_t`, `printer::end_t` and `printer::flush_t`.
- * You can define variables of these types somewhere else, use the static variables in the `printer` namespace (
- * `printer::file`, `printer::sep`, `printer::end` and `printer::flush`) or use rvalues of these types:
+ * this file. These variables are of type `printer::file_t`, `printer::sep_t`, `printer::end_t`, `printer::prefix_t`
+ * and `printer::flush_t`. You can define variables of these types somewhere else, use the static variables in the
+ * `printer` namespace (`printer::file`, `printer::sep`, `printer::end`, `printer::prefix` and `printer::flush`) or
+ * use rvalues of these types:
  *
  *      constexpr printer::sep_t my_sep;
  *      // All three of these are equivalent
@@ -74,6 +81,9 @@
  * copies something). `noexcept` is also calculated properly, and (not in gcc, but in clang and msvc) `print();`
  * will be `constexpr` if possible.
  *
+ * In C++17 and later, `print` is implemented with fold expressions, which is much cheaper to compile with many
+ * arguments. Define `PRINT_NO_FOLD_ENGINE` to use the C++11 implementation instead (They behave the same).
+ *
  * By default, `flush` calls `file.flush();` but only if a `flush=(value)` argument is passed at all (So it is safe
  * to pass something that can't be flushed if you don't pass a `flush=(value)` argument, but you can't pass `flush=false`).
  * To customise this behaviour, pass a class as a template parameter that has an `operator()(MyStreamType) const`:
@@ -92,15 +102,148 @@
 #ifndef PRINT_H_
 #define PRINT_H_
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
+// Define `PRINT_ENABLE_FD_READ` for `printer::reader` to also read from file descriptors. This is opt-in because it
+// includes `<unistd.h>` (or `<io.h>`), which declares `read`, `write`, `close`, etc. in the global namespace.
+#ifdef PRINT_ENABLE_FD_READ
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#define PRINT_HAS_FD_READ 1
+#elif defined(_WIN32)
+#include <cerrno>
+#include <io.h>
+#define PRINT_HAS_FD_READ 1
+#endif
+#endif
+
+// `printer::read` parses floating point numbers with `std::from_chars` if possible
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define PRINT_HAS_FLOAT_FROM_CHARS 1
+#endif
+#endif
+#endif
+#ifndef PRINT_HAS_FLOAT_FROM_CHARS
+#include <clocale>
+#endif
+
+// Static tracepoints (provider `print`, probes `entry`, `flush_entry`, `flush_exit` and `exit`) are only there if
+// `PRINT_ENABLE_PROBES` is defined, so `perf` and `bpftrace` can attach to them. They use `<sys/sdt.h>` if it exists,
+// otherwise the same `.note.stapsdt` ELF notes are emitted directly (gcc and clang on x86-64 and AArch64).
+// Or define `PRINT_PROBE1(name, a)` and `PRINT_PROBE3(name, a, b, c)` before including this file to use some other
+// tracing mechanism (And optionally `PRINT_PROBE_ENABLED(name)`, which defaults to 1). If none of those, there
+// are no probes.
+//
+// The `bytes` argument of `exit` is only counted while a tracer is attached to it (Which `perf` and `bpftrace` signal
+// with a semaphore), so the probes are a `nop` each otherwise. While counted, a line printed to an `std::ostream` is
+// formatted into a buffer and written at once, so `std::flush` as an argument does nothing then. With `<sys/sdt.h>`, this needs `_SDT_HAS_SEMAPHORES`
+// to be defined, or `bytes` is always -1.
+#ifdef PRINT_ENABLE_PROBES
+#if !defined(PRINT_PROBE1) && !defined(PRINT_PROBE3)
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PRINT_PROBE1(name, a) STAP_PROBE1(print, name, a)
+#define PRINT_PROBE3(name, a, b, c) STAP_PROBE3(print, name, a, b, c)
+#ifdef _SDT_HAS_SEMAPHORES
+#define PRINT_PROBE_SEMAPHORES 1
+#else
+#define PRINT_PROBE_ENABLED(name) 0
+#endif
+#endif
+#endif
+#if !defined(PRINT_PROBE1) && defined(__GNUC__) && defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+// What `STAP_PROBEn` expands to: a `nop` at the probe site, and a note with its address, the semaphore's address,
+// the provider and probe names, and where to find the arguments (All 8 byte signed integers in registers)
+#define PRINT_PROBE_NOTE(name, args) \
+    "990: nop\n" \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n" \
+    ".balign 4\n" \
+    ".4byte 992f-991f, 994f-993f, 3\n" \
+    "991: .asciz \"stapsdt\"\n" \
+    "992: .balign 4\n" \
+    "993: .8byte 990b\n" \
+    ".8byte _.stapsdt.base\n" \
+    ".8byte print_" #name "_semaphore\n" \
+    ".asciz \"print\"\n" \
+    ".asciz \"" #name "\"\n" \
+    ".asciz \"" args "\"\n" \
+    "994: .balign 4\n" \
+    ".popsection\n" \
+    ".ifndef _.stapsdt.base\n" \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+    ".weak _.stapsdt.base\n" \
+    ".hidden _.stapsdt.base\n" \
+    "_.stapsdt.base: .space 1\n" \
+    ".size _.stapsdt.base, 1\n" \
+    ".popsection\n" \
+    ".endif\n"
+#define PRINT_PROBE1(name, a) \
+    __asm__ __volatile__(PRINT_PROBE_NOTE(name, "-8@%0") :: "r"(static_cast<long long>(a)))
+#define PRINT_PROBE3(name, a, b, c) \
+    __asm__ __volatile__(PRINT_PROBE_NOTE(name, "-8@%0 -8@%1 -8@%2") :: \
+        "r"(static_cast<long long>(a)), "r"(static_cast<long long>(b)), "r"(static_cast<long long>(c)))
+#define PRINT_PROBE_SEMAPHORES 1
+#endif
+#endif
+#if defined(PRINT_PROBE1) && defined(PRINT_PROBE3)
+#define PRINT_HAS_PROBES 1
+#include <sstream>
+#ifdef PRINT_PROBE_SEMAPHORES
+// Incremented by tracers while they are attached. Weak, so every translation unit can define them.
+#define PRINT_PROBE_SEMAPHORE(name) \
+    __attribute__((weak, visibility("hidden"), section(".probes"))) volatile unsigned short print_##name##_semaphore = 0
+extern "C" {
+PRINT_PROBE_SEMAPHORE(entry);
+PRINT_PROBE_SEMAPHORE(flush_entry);
+PRINT_PROBE_SEMAPHORE(flush_exit);
+PRINT_PROBE_SEMAPHORE(exit);
+}
+#undef PRINT_PROBE_SEMAPHORE
+#define PRINT_PROBE_ENABLED(name) (print_##name##_semaphore != 0)
+#endif
+#ifndef PRINT_PROBE_ENABLED
+#define PRINT_PROBE_ENABLED(name) 1
+#endif
+#endif
+#endif
+
+// `printer::async_print` needs C++20 coroutines
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <sstream>
+#define PRINT_HAS_COROUTINES 1
+#endif
+#endif
+
 // gcc segfaults if constexpr because of the comma expressions?
-#if !defined(__GNUC__) || defined(__clang__) || __cplusplus >= 201402L
+// With probes, `print` is never constexpr.
+#if (!defined(__GNUC__) || defined(__clang__) || __cplusplus >= 201402L) && !defined(PRINT_HAS_PROBES)
 #define PRINT_IS_CONSTEXPR 1
 #endif
 
+// C++17 uses fold expressions and `if constexpr` instead of recursive overloads, which instantiates far fewer
+// templates. Define `PRINT_NO_FOLD_ENGINE` to use the C++11 implementation anyway.
+#if __cplusplus >= 201703L && !defined(PRINT_NO_FOLD_ENGINE)
+#define PRINT_FOLD_ENGINE 1
+#endif
+
 // -Wcomma is just broken for some reason (Saying to wrap expressions in `static_cast<void>(static_cast<void>(...))`)
 // Also don't care about padding for internal struct `printer::detail::print_options`
 // The only other warning is -Wc++98-compat, which this header is not, so you should not have it enabled when compiling
@@ -159,6 +302,18 @@ namespace printer {
         }
     };
 
+    struct prefix_t {
+        template<class T>
+        struct value_t {
+            T&& value;
+        };
+
+        template<class T>
+        constexpr value_t<T> operator=(T&& value) const noexcept {  // NOLINT
+            return value_t<T>{ ::std::forward<T>(value) };
+        }
+    };
+
     struct flush_t {
         struct value_t {
             bool value;
@@ -225,13 +380,14 @@ namespace printer {
 
 #ifdef PRINT_TRY_COMBINE_STATICS
     namespace detail {
-        struct static_variables_t : sep_t, end_t, file_t, flush_t, print_nothing_t { };
+        struct static_variables_t : sep_t, end_t, file_t, prefix_t, flush_t, print_nothing_t { };
         static constexpr const static_variables_t static_variables;
     }
 
     static constexpr const sep_t& sep = detail::static_variables;
     static constexpr const end_t& end = detail::static_variables;
     static constexpr const file_t& file = detail::static_variables;
+    static constexpr const prefix_t& prefix = detail::static_variables;
     static constexpr const flush_t& flush = detail::static_variables;
 
     static constexpr const print_nothing_t& print_nothing = detail::static_variables;
@@ -239,10 +395,467 @@ namespace printer {
     static constexpr const sep_t sep;
     static constexpr const end_t end;
     static constexpr const file_t file;
+    static constexpr const prefix_t prefix;
     static constexpr const flush_t flush;
 
     static constexpr const print_nothing_t print_nothing;
 #endif
+
+    namespace detail {
+        struct timestamp_cache {
+            // Any more `%f`s than this are printed as is
+            static constexpr const unsigned max_fractions = 8U;
+
+            const char* format = nullptr;
+            bool utc = false;
+            bool valid = false;
+            long long granularity = 1;  // Seconds between changes in the `strftime` part of the output
+            long long key = 0;
+            ::std::string formats;  // The `strftime` formats around each `%f`, each null terminated
+            unsigned fractions = 0U;
+            unsigned digits[max_fractions] = {};
+            ::std::size_t positions[max_fractions] = {};
+            ::std::string text;
+
+            void reset(const char* format_, bool utc_) {
+                format = format_;
+                utc = utc_;
+                valid = false;
+                granularity = 60;
+                fractions = 0U;
+                formats.clear();
+                const char* p = format_;
+                while (*p != '\0') {
+                    if (*p != '%' || p[1] == '\0') {
+                        formats.push_back(*p++);
+                        continue;
+                    }
+                    const char* spec = p + 1;
+                    unsigned spec_digits = 6U;
+                    bool modified = false;
+                    if (*spec >= '1' && *spec <= '9' && spec[1] == 'f') {
+                        spec_digits = static_cast<unsigned>(*spec - '0');
+                        ++spec;
+                    } else if ((*spec == 'E' || *spec == 'O') && spec[1] != '\0') {
+                        modified = true;
+                        ++spec;
+                    }
+                    if (*spec == 'f' && !modified) {
+                        granularity = 1;
+                        if (fractions != max_fractions) {
+                            formats.push_back('\0');
+                            digits[fractions++] = spec_digits;
+                            p = spec + 1;
+                            continue;
+                        }
+                        formats.push_back('%');
+                    } else if (::std::strchr("SsTXcr+", *spec) != nullptr) {
+                        granularity = 1;
+                    }
+                    formats.append(p, spec + 1);
+                    p = spec + 1;
+                }
+            }
+
+            static void append_strftime(::std::string& out, const char* fmt, const ::std::tm& tm) {
+                if (*fmt == '\0') return;
+                char buf[256];
+                const ::std::size_t size = ::std::strftime(buf, sizeof(buf), fmt, &tm);
+                out.append(buf, size);
+            }
+
+            void refresh(::std::time_t seconds) {
+                ::std::tm tm{};
+#ifdef _WIN32
+                static_cast<void>(utc ? ::gmtime_s(&tm, &seconds) : ::localtime_s(&tm, &seconds));
+#else
+                static_cast<void>(utc ? ::gmtime_r(&seconds, &tm) : ::localtime_r(&seconds, &tm));
+#endif
+                text.clear();
+                const char* fmt = formats.c_str();
+                for (unsigned i = 0U; i != fractions; ++i) {
+                    append_strftime(text, fmt, tm);
+                    fmt += ::std::strlen(fmt) + 1U;
+                    positions[i] = text.size();
+                    text.append(digits[i], '0');
+                }
+                append_strftime(text, fmt, tm);
+            }
+
+            void write_fractions(long long nanoseconds) {
+                for (unsigned i = 0U; i != fractions; ++i) {
+                    long long value = nanoseconds;
+                    for (unsigned j = digits[i]; j < 9U; ++j) value /= 10;
+                    for (::std::size_t pos = positions[i] + digits[i]; pos != positions[i]; value /= 10) {
+                        text[--pos] = static_cast<char>('0' + value % 10);
+                    }
+                }
+            }
+        };
+
+        // A few caches per thread, so alternating between formats doesn't recompute every time
+        struct timestamp_caches {
+            static constexpr const unsigned slot_count = 4U;
+
+            timestamp_cache slots[slot_count];
+            unsigned next = 0U;
+
+            timestamp_cache& get(const char* format, bool utc) {
+                for (timestamp_cache& cache : slots) {
+                    if (cache.format == format && cache.utc == utc) return cache;
+                }
+                for (timestamp_cache& cache : slots) {
+                    if (cache.format != nullptr && cache.utc == utc && ::std::strcmp(cache.format, format) == 0) {
+                        cache.format = format;
+                        return cache;
+                    }
+                }
+                timestamp_cache& cache = slots[next];
+                next = (next + 1U) % slot_count;
+                cache.reset(format, utc);
+                return cache;
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * Outputs the current date and time, formatted with `strftime`. Meant to be used as `prefix=printer::timestamp()`.
+     *
+     * `%f` is the fraction of the current second as 6 digits (Like Python's `datetime.strftime`), and `%1f` to `%9f`
+     * choose the number of digits.
+     *
+     * The `strftime` output is cached per thread and format, and is only recomputed once a second (Or once a minute
+     * if `format` has nothing finer than minutes). Otherwise only the digits of `%f` are rewritten. The cache is keyed
+     * on `format`, so it should point to a string that is not modified (e.g. a string literal).
+     */
+    class timestamp {
+    public:
+        constexpr explicit timestamp(const char* format = "%Y-%m-%d %H:%M:%S.%f", bool utc = false) noexcept : format_(format), utc_(utc) {}
+
+        // The formatted time. Reference is valid until the next call on the same thread.
+        const ::std::string& str() const {
+            static thread_local detail::timestamp_caches caches;
+
+            const long long since_epoch = static_cast<long long>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+                ::std::chrono::system_clock::now().time_since_epoch()
+            ).count());
+            long long seconds = since_epoch / 1000000000;
+            long long nanoseconds = since_epoch % 1000000000;
+            if (nanoseconds < 0) {
+                nanoseconds += 1000000000;
+                --seconds;
+            }
+
+            detail::timestamp_cache& cache = caches.get(format_, utc_);
+            long long key = seconds / cache.granularity;
+            if (seconds < 0 && seconds % cache.granularity != 0) --key;
+            if (!cache.valid || key != cache.key) {
+                cache.refresh(static_cast<::std::time_t>(seconds));
+                cache.key = key;
+                cache.valid = true;
+            }
+
+            cache.write_fractions(nanoseconds);
+            return cache.text;
+        }
+
+        friend ::std::ostream& operator<<(::std::ostream& os, const timestamp& ts) {
+            const ::std::string& text = ts.str();
+            return os.write(text.data(), static_cast<::std::streamsize>(text.size()));
+        }
+
+    private:
+        const char* format_;
+        bool utc_;
+    };
+
+    namespace detail {
+        class dedup_streambuf : public ::std::streambuf {
+        public:
+            dedup_streambuf(::std::ostream& out, ::std::chrono::steady_clock::duration timeout) : out_(out), timeout_(timeout) {}
+            dedup_streambuf(const dedup_streambuf&) = delete;
+            dedup_streambuf& operator=(const dedup_streambuf&) = delete;
+
+            ~dedup_streambuf() override {
+                write_summary();
+                out_.write(line_.data(), static_cast<::std::streamsize>(line_.size()));
+            }
+
+        protected:
+            int_type overflow(int_type ch) override {
+                if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+                const char c = traits_type::to_char_type(ch);
+                put(&c, 1U);
+                return ch;
+            }
+
+            ::std::streamsize xsputn(const char* s, ::std::streamsize count) override {
+                put(s, static_cast<::std::size_t>(count));
+                return count;
+            }
+
+            int sync() override {
+                if (repeats_ != 0U && ::std::chrono::steady_clock::now() - first_repeat_ >= timeout_) write_summary();
+                return out_.flush().fail() ? -1 : 0;
+            }
+
+        private:
+            static constexpr const ::std::uint64_t fnv_offset_basis = 14695981039346656037ULL;
+            static constexpr const ::std::uint64_t fnv_prime = 1099511628211ULL;
+
+            void put(const char* s, ::std::size_t count) {
+                while (count != 0U) {
+                    const char* newline = static_cast<const char*>(::std::memchr(s, '\n', count));
+                    const ::std::size_t length = newline == nullptr ? count : static_cast<::std::size_t>(newline - s) + 1U;
+                    for (::std::size_t i = 0U; i != length; ++i) {
+                        hash_ = (hash_ ^ static_cast<unsigned char>(s[i])) * fnv_prime;
+                    }
+                    line_.append(s, length);
+                    s += length;
+                    count -= length;
+                    if (newline != nullptr) end_line();
+                }
+            }
+
+            void end_line() {
+                // Only compare the whole line if the hashes match, in case of collisions
+                if (has_last_ && hash_ == last_hash_ && line_ == last_line_) {
+                    const ::std::chrono::steady_clock::time_point now = ::std::chrono::steady_clock::now();
+                    if (repeats_++ == 0U) {
+                        first_repeat_ = now;
+                    } else if (now - first_repeat_ >= timeout_) {
+                        write_summary();
+                    }
+                } else {
+                    write_summary();
+                    out_.write(line_.data(), static_cast<::std::streamsize>(line_.size()));
+                    last_line_.swap(line_);
+                    last_hash_ = hash_;
+                    has_last_ = true;
+                }
+                line_.clear();
+                hash_ = fnv_offset_basis;
+            }
+
+            void write_summary() {
+                if (repeats_ == 0U) return;
+                out_ << "last line repeated " << repeats_ << (repeats_ == 1U ? " time\n" : " times\n");
+                repeats_ = 0U;
+            }
+
+            ::std::ostream& out_;
+            const ::std::chrono::steady_clock::duration timeout_;
+            ::std::string line_;
+            ::std::string last_line_;
+            ::std::uint64_t hash_ = fnv_offset_basis;
+            ::std::uint64_t last_hash_ = 0U;
+            bool has_last_ = false;
+            unsigned long long repeats_ = 0U;
+            ::std::chrono::steady_clock::time_point first_repeat_;
+        };
+    }  // namespace detail
+
+    /**
+     * A stream that passes lines through to `out`, except for lines that are the same as the previous line.
+     * Those are counted instead, and replaced with a single "last line repeated N times" line when a different
+     * line is written, or when `timeout` has passed since the first repeat (Checked on each line and on flush).
+     *
+     *     printer::dedup_sink log(std::cerr);
+     *     for (int i = 0; i < 1000; ++i) print("Connection refused", file=log);
+     *     // Prints "Connection refused\nlast line repeated 999 times\n" (Once `log` is destroyed)
+     *
+     * Lines are hashed as they are written, so they only have to be compared if the hash matches. Anything written
+     * after the last newline is only passed through on destruction, so a flush will not split a line.
+     */
+    class dedup_sink : public ::std::ostream {
+    public:
+        explicit dedup_sink(::std::ostream& out_, ::std::chrono::steady_clock::duration timeout_ = ::std::chrono::seconds(1)) :
+            ::std::ostream(nullptr), buf_(out_, timeout_) {
+            rdbuf(&buf_);
+        }
+
+    private:
+        detail::dedup_streambuf buf_;
+    };
+
+    namespace detail {
+        enum class tee_flush : unsigned char {
+            follow,  // Flushed when the `tee` is flushed
+            always,  // Flushed every time bytes are written to it
+            never
+        };
+
+        template<class T, tee_flush Policy>
+        struct tee_destination {
+            // `T` is an lvalue reference for lvalue destinations, otherwise the destination is moved into the `tee`
+            T dest;
+
+            explicit tee_destination(T&& dest_) : dest(::std::forward<T>(dest_)) {}
+        };
+
+        template<class T>
+        struct tee_destination_of {
+            using type = tee_destination<T, tee_flush::follow>;
+        };
+
+        template<class T, tee_flush Policy>
+        struct tee_destination_of<tee_destination<T, Policy>> {
+            using type = tee_destination<T, Policy>;
+        };
+
+        template<class T, tee_flush Policy>
+        struct tee_destination_of<tee_destination<T, Policy>&> : tee_destination_of<tee_destination<T, Policy>> {};
+
+        template<class T, tee_flush Policy>
+        struct tee_destination_of<const tee_destination<T, Policy>&> : tee_destination_of<tee_destination<T, Policy>> {};
+
+        template<class T>
+        auto tee_write(T& dest, const ::std::string& bytes, int /*unused*/) -> decltype(static_cast<void>(dest.write(bytes.data(), ::std::streamsize()))) {
+            dest.write(bytes.data(), static_cast<::std::streamsize>(bytes.size()));
+        }
+
+        template<class T>
+        void tee_write(T& dest, const ::std::string& bytes, long /*unused*/) {
+            dest << bytes;
+        }
+
+        template<class T>
+        auto tee_flush_dest(T& dest, int /*unused*/) -> decltype(static_cast<void>(dest.flush())) {
+            dest.flush();
+        }
+
+        template<class T>
+        void tee_flush_dest(T& /*unused*/, long /*unused*/) {}
+
+        template<class T>
+        void tee_flush_destination(tee_destination<T, tee_flush::follow>& d, bool flushing) {
+            if (flushing) tee_flush_dest(d.dest, 0);
+        }
+
+        template<class T>
+        void tee_flush_destination(tee_destination<T, tee_flush::always>& d, bool /*unused*/) {
+            tee_flush_dest(d.dest, 0);
+        }
+
+        template<class T>
+        void tee_flush_destination(tee_destination<T, tee_flush::never>& /*unused*/, bool /*unused*/) {}
+
+        template<class... Dests>
+        class tee_streambuf : public ::std::streambuf {
+        public:
+            template<class... U>
+            explicit tee_streambuf(U&&... dests) : dests_(::std::forward<U>(dests)...) {}
+
+            tee_streambuf(tee_streambuf&& other) :
+                ::std::streambuf(other), buffer_(::std::move(other.buffer_)), dests_(::std::move(other.dests_)), active_(other.active_) {
+                other.active_ = false;
+            }
+            tee_streambuf& operator=(tee_streambuf&&) = delete;
+
+            // Exceptions from destinations can't be reported from here, so they are ignored
+            ~tee_streambuf() override {
+                if (active_) static_cast<void>(write_out(false));
+            }
+
+        protected:
+            int_type overflow(int_type ch) override {
+                if (!traits_type::eq_int_type(ch, traits_type::eof())) buffer_.push_back(traits_type::to_char_type(ch));
+                return traits_type::not_eof(ch);
+            }
+
+            ::std::streamsize xsputn(const char* s, ::std::streamsize count) override {
+                buffer_.append(s, static_cast<::std::size_t>(count));
+                return count;
+            }
+
+            // Fails (So flushing the `tee` sets `badbit`) if any destination threw
+            int sync() override {
+                return write_out(true) ? 0 : -1;
+            }
+
+        private:
+            bool write_out(bool flushing) {
+                if (buffer_.empty() && !flushing) return true;
+                const bool written = write_each(flushing);
+                buffer_.clear();
+                return written;
+            }
+
+            template<::std::size_t I = 0U>
+            typename ::std::enable_if<I == sizeof...(Dests), bool>::type write_each(bool /*unused*/) noexcept {
+                return true;
+            }
+
+            // A destination that throws doesn't stop the others from being written to
+            template<::std::size_t I = 0U>
+            typename ::std::enable_if<I != sizeof...(Dests), bool>::type write_each(bool flushing) noexcept {
+                bool written = true;
+                try {
+                    auto& d = ::std::get<I>(dests_);
+                    if (!buffer_.empty()) tee_write(d.dest, buffer_, 0);
+                    tee_flush_destination(d, flushing);
+                } catch (...) {
+                    written = false;
+                }
+                return write_each<I + 1U>(flushing) && written;
+            }
+
+            ::std::string buffer_;
+            ::std::tuple<Dests...> dests_;
+            bool active_ = true;
+        };
+    }  // namespace detail
+
+    /**
+     * A stream that buffers everything written to it, and writes the bytes to each destination when it is flushed
+     * or destroyed. Made by `printer::tee`.
+     */
+    template<class... Dests>
+    class tee_sink : public ::std::ostream {
+    public:
+        template<class... U>
+        explicit tee_sink(U&&... dests) : ::std::ostream(nullptr), buf_(::std::forward<U>(dests)...) {
+            rdbuf(&buf_);
+        }
+
+        tee_sink(tee_sink&& other) : ::std::ostream(::std::move(other)), buf_(::std::move(other.buf_)) {
+            set_rdbuf(&buf_);
+        }
+
+    private:
+        detail::tee_streambuf<Dests...> buf_;
+    };
+
+    /**
+     * Formats once, and writes the bytes to every destination. Destinations can be anything `file=` accepts.
+     * Destinations that have a `write(const char*, std::streamsize)` member have the bytes written with that,
+     * everything else gets `dest << std::string`.
+     *
+     *     std::ofstream log("log.txt");
+     *     print("Hello, world!", file=printer::tee(std::cout, log));
+     *
+     * As a temporary, the `tee` writes to each destination at the end of the `print` statement. Destinations are
+     * flushed with their `flush()` member function (if they have one) when the `tee` is flushed, unless they are
+     * wrapped with `printer::never_flush(dest)`. `printer::always_flush(dest)` flushes that destination after every
+     * write.
+     *
+     * If a destination throws, the other destinations are still written to. Flushing the `tee` then sets its
+     * `badbit`, but when the bytes are written by the destructor of the `tee`, the exception is ignored.
+     */
+    template<class... Dests>
+    tee_sink<typename detail::tee_destination_of<Dests>::type...> tee(Dests&&... dests) {
+        return tee_sink<typename detail::tee_destination_of<Dests>::type...>(::std::forward<Dests>(dests)...);
+    }
+
+    template<class T>
+    detail::tee_destination<T, detail::tee_flush::always> always_flush(T&& dest) {
+        return detail::tee_destination<T, detail::tee_flush::always>(::std::forward<T>(dest));
+    }
+
+    template<class T>
+    detail::tee_destination<T, detail::tee_flush::never> never_flush(T&& dest) {
+        return detail::tee_destination<T, detail::tee_flush::never>(::std::forward<T>(dest));
+    }
 }  // namespace printer
 
 
@@ -252,7 +865,8 @@ namespace printer { namespace detail {
         sep = 1,
         end = 2,
         file = 4,
-        flush = 8
+        flush = 8,
+        prefix = 16
     };
 
     constexpr bool operator&(print_manipulated lhs, print_manipulated rhs) noexcept {
@@ -267,62 +881,69 @@ namespace printer { namespace detail {
     template<class T>
     struct dependant_false : ::std::false_type { };
 
-    template<class SepT, class EndT, class FileT, print_manipulated Manipulated = print_manipulated::none>
+    template<class SepT, class EndT, class FileT, class PrefixT, print_manipulated Manipulated = print_manipulated::none>
     // NOLINTNEXTLINE(cppcoreguidelines-special-member-functions, hicpp-special-member-functions): Move constructor would be worthless
     struct print_options {
         SepT&& sep;
         EndT&& end;
         FileT&& file;
+        PrefixT&& prefix;
         const bool flush;
 
 
-        constexpr print_options(SepT&& sep_, EndT&& end_, FileT&& file_, const bool flush_) noexcept :
-            sep(::std::forward<SepT>(sep_)), end(::std::forward<EndT>(end_)), file(::std::forward<FileT>(file_)), flush(flush_) {}
+        constexpr print_options(SepT&& sep_, EndT&& end_, FileT&& file_, PrefixT&& prefix_, const bool flush_) noexcept :
+            sep(::std::forward<SepT>(sep_)), end(::std::forward<EndT>(end_)), file(::std::forward<FileT>(file_)), prefix(::std::forward<PrefixT>(prefix_)), flush(flush_) {}
 
-        constexpr print_options(const print_options& other) noexcept : sep(::std::forward<SepT>(other.sep)), end(::std::forward<EndT>(other.end)), file(::std::forward<FileT>(other.file)), flush(other.flush) {}
+        constexpr print_options(const print_options& other) noexcept : sep(::std::forward<SepT>(other.sep)), end(::std::forward<EndT>(other.end)), file(::std::forward<FileT>(other.file)), prefix(::std::forward<PrefixT>(other.prefix)), flush(other.flush) {}
         constexpr print_options& operator=(const print_options&) const noexcept = delete;  // Can't copy references
         ~print_options() noexcept = default;
 
         static constexpr const bool set_sep = Manipulated & print_manipulated::sep;
         static constexpr const bool set_end = Manipulated & print_manipulated::end;
         static constexpr const bool set_file = Manipulated & print_manipulated::file;
+        static constexpr const bool set_prefix = Manipulated & print_manipulated::prefix;
         static constexpr const bool set_flush = Manipulated & print_manipulated::flush;
 
         template<class T>
-        constexpr print_options<T, EndT, FileT, Manipulated | print_manipulated::sep> operator+(const sep_t::value_t<T>& new_sep) const noexcept {
+        constexpr print_options<T, EndT, FileT, PrefixT, Manipulated | print_manipulated::sep> operator+(const sep_t::value_t<T>& new_sep) const noexcept {
             static_assert(dependant_false<T>::value || !set_sep, "`sep` keyword argument passed multiple times to print().");
-            return { ::std::forward<T>(new_sep.value), ::std::forward<EndT>(end), ::std::forward<FileT>(file), flush };
+            return { ::std::forward<T>(new_sep.value), ::std::forward<EndT>(end), ::std::forward<FileT>(file), ::std::forward<PrefixT>(prefix), flush };
         }
         template<class T>
-        constexpr print_options<SepT, T, FileT, Manipulated | print_manipulated::end> operator+(const end_t::value_t<T>& new_end) const noexcept {
+        constexpr print_options<SepT, T, FileT, PrefixT, Manipulated | print_manipulated::end> operator+(const end_t::value_t<T>& new_end) const noexcept {
             static_assert(dependant_false<T>::value || !set_end, "`end` keyword argument passed multiple times to print().");
-            return { ::std::forward<SepT>(sep), ::std::forward<T>(new_end.value), ::std::forward<FileT>(file), flush };
+            return { ::std::forward<SepT>(sep), ::std::forward<T>(new_end.value), ::std::forward<FileT>(file), ::std::forward<PrefixT>(prefix), flush };
         }
         template<class T>
-        constexpr print_options<SepT, EndT, T, Manipulated | print_manipulated::file> operator+(const file_t::value_t<T>& new_file) const noexcept {
+        constexpr print_options<SepT, EndT, T, PrefixT, Manipulated | print_manipulated::file> operator+(const file_t::value_t<T>& new_file) const noexcept {
             static_assert(dependant_false<T>::value || !set_file, "`file` keyword argument passed multiple times to print().");
-            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<T>(new_file.value), flush };
+            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<T>(new_file.value), ::std::forward<PrefixT>(prefix), flush };
+        }
+        template<class T>
+        constexpr print_options<SepT, EndT, FileT, T, Manipulated | print_manipulated::prefix> operator+(const prefix_t::value_t<T>& new_prefix) const noexcept {
+            static_assert(dependant_false<T>::value || !set_prefix, "`prefix` keyword argument passed multiple times to print().");
+            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<FileT>(file), ::std::forward<T>(new_prefix.value), flush };
         }
         template<class T = void>
-        constexpr print_options<SepT, EndT, FileT, Manipulated | print_manipulated::flush> operator+(const flush_t::value_t& new_flush) const noexcept {
+        constexpr print_options<SepT, EndT, FileT, PrefixT, Manipulated | print_manipulated::flush> operator+(const flush_t::value_t& new_flush) const noexcept {
             static_assert(dependant_false<T>::value || !set_flush, "`flush` keyword argument passed multiple times to print().");
-            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<FileT>(file), new_flush.value };
+            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<FileT>(file), ::std::forward<PrefixT>(prefix), new_flush.value };
         }
         template<class T = print_nothing_t>
-        constexpr print_options<T, EndT, FileT, Manipulated | print_manipulated::sep> operator+(const sep_t& /*unused*/) const noexcept {
+        constexpr print_options<T, EndT, FileT, PrefixT, Manipulated | print_manipulated::sep> operator+(const sep_t& /*unused*/) const noexcept {
             // Just `sep` is an alias for `sep=print_nothing_t`
             return *this + (sep_t()=T());
         }
         template<class T = print_nothing_t>
-        constexpr print_options<SepT, T, FileT, Manipulated | print_manipulated::end> operator+(const end_t& /*unused*/) const noexcept {
+        constexpr print_options<SepT, T, FileT, PrefixT, Manipulated | print_manipulated::end> operator+(const end_t& /*unused*/) const noexcept {
             // Just `end` is an alias for `end=print_nothing_t`
             return *this + (end_t()=T());
         }
         template<class T = flush_t>
-        constexpr print_options<SepT, EndT, FileT, Manipulated | print_manipulated::flush> operator+(const flush_t& /*unused*/) const noexcept {
+        constexpr print_options<SepT, EndT, FileT, PrefixT, Manipulated | print_manipulated::flush> operator+(const flush_t& /*unused*/) const noexcept {
             // Just `flush` is an alias for `flush=true`
             static_assert(dependant_false<T>::value || !set_flush, "`flush` keyword argument passed multiple times to print().");
-            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<FileT>(file), true };
+            return { ::std::forward<SepT>(sep), ::std::forward<EndT>(end), ::std::forward<FileT>(file), ::std::forward<PrefixT>(prefix), true };
         }
 
         template<class T> constexpr const print_options& operator+(const T& /*unused*/) const noexcept { return *this; }
@@ -332,6 +953,7 @@ namespace printer { namespace detail {
     template<class T> struct is_print_opt_value<sep_t::value_t<T>> : ::std::true_type {};
     template<class T> struct is_print_opt_value<end_t::value_t<T>> : ::std::true_type {};
     template<class T> struct is_print_opt_value<file_t::value_t<T>> : ::std::true_type {};
+    template<class T> struct is_print_opt_value<prefix_t::value_t<T>> : ::std::true_type {};
     template<> struct is_print_opt_value<flush_t::value_t> : ::std::true_type {};
     template<> struct is_print_opt_value<sep_t> : ::std::true_type {};
     template<> struct is_print_opt_value<end_t> : ::std::true_type {};
@@ -340,26 +962,35 @@ namespace printer { namespace detail {
     template<class T>
     struct is_fwd_print_opt_value : ::std::integral_constant<bool, is_print_opt_value<typename ::std::remove_cv<typename ::std::remove_reference<T>::type>::type>::value> {};
 
-#if __cplusplus >= 201703L
-    template<class SepT, class EndT, class FileT, print_manipulated Manipulated, class... Args>
-    constexpr auto combine_options(const print_options<SepT, EndT, FileT, Manipulated>& opts, Args&&... args) noexcept {
+#ifdef PRINT_FOLD_ENGINE
+    template<class SepT, class EndT, class FileT, class PrefixT, print_manipulated Manipulated, class... Args>
+    constexpr auto combine_options(const print_options<SepT, EndT, FileT, PrefixT, Manipulated>& opts, Args&&... args) noexcept {
         return (opts + ... + args);
     }
 #else
-    template<class SepT, class EndT, class FileT, print_manipulated Manipulated>
-    constexpr print_options<SepT, EndT, FileT, Manipulated> combine_options(const print_options<SepT, EndT, FileT, Manipulated>& opts) noexcept {
+    template<class SepT, class EndT, class FileT, class PrefixT, print_manipulated Manipulated>
+    constexpr print_options<SepT, EndT, FileT, PrefixT, Manipulated> combine_options(const print_options<SepT, EndT, FileT, PrefixT, Manipulated>& opts) noexcept {
         return opts;
     }
 
-    template<class SepT, class EndT, class FileT, print_manipulated Manipulated, class T, class... U>
+    template<class SepT, class EndT, class FileT, class PrefixT, print_manipulated Manipulated, class T, class... U>
 #ifdef PRINT_IS_CONSTEXPR
     constexpr
 #endif
-    auto combine_options(const print_options<SepT, EndT, FileT, Manipulated>& opts, const T& t, const U&... u) noexcept -> decltype(combine_options(opts + t, u...)) {
+    auto combine_options(const print_options<SepT, EndT, FileT, PrefixT, Manipulated>& opts, const T& t, const U&... u) noexcept -> decltype(combine_options(opts + t, u...)) {
         return combine_options(opts + t, u...);
     }
 #endif
 
+#ifdef PRINT_FOLD_ENGINE
+    template<class... Args>
+    struct print_can_possibly_flush : ::std::integral_constant<bool,
+        (false || ... || (is_fwd_same<Args, flush_t::value_t>::value || is_fwd_same<Args, flush_t>::value))
+    > { };
+
+    template<class... Args>
+    struct print_will_always_flush : ::std::integral_constant<bool, (false || ... || is_fwd_same<Args, flush_t>::value)> { };
+#else
     constexpr bool fold_or(bool b) noexcept {
         return b;
     }
@@ -379,6 +1010,8 @@ namespace printer { namespace detail {
         false, (is_fwd_same<Args, flush_t>::value)...
     )> { };
 
+#endif
+
 #if __cplusplus >= 201402L
     template<bool AlwaysFlush, bool CanFlush, class Flusher, class FileT>
     constexpr
@@ -417,6 +1050,69 @@ namespace printer { namespace detail {
     using constexpr_return_type = int;
 #endif
 
+#ifdef PRINT_FOLD_ENGINE
+    enum class print_arg_kind : unsigned char {
+        option,
+        nothing,
+        value
+    };
+
+    template<class Arg>
+    constexpr print_arg_kind print_arg_kind_of =
+        is_fwd_print_opt_value<Arg>::value ? print_arg_kind::option :
+        is_fwd_same<Arg, print_nothing_t>::value ? print_arg_kind::nothing :
+        print_arg_kind::value;
+
+    // `sep` goes before a value if the closest argument before it that isn't an option is another value
+    // (And not `print_nothing`). `PrintSep` is used if there isn't one.
+    template<bool PrintSep, class... Args>
+    constexpr bool print_sep_before(::std::size_t index) noexcept {
+        constexpr print_arg_kind kinds[] = { print_arg_kind_of<Args>..., print_arg_kind::option };
+        while (index-- != 0U) {
+            if (kinds[index] != print_arg_kind::option) return kinds[index] == print_arg_kind::value;
+        }
+        return PrintSep;
+    }
+
+    template<class PrintOptionsT, bool PrintSep = true>
+    struct is_sep_noexcept : ::std::integral_constant<bool, noexcept(::std::declval<PrintOptionsT>().file << ::std::declval<PrintOptionsT>().sep)> {};
+
+    template<class PrintOptionsT>
+    struct is_sep_noexcept<PrintOptionsT, false> : ::std::true_type {};
+
+    template<bool PrintSep, class PrintOptionsT, class Arg, print_arg_kind Kind = print_arg_kind_of<Arg>>
+    struct is_print_arg_noexcept : ::std::true_type {};
+
+    template<bool PrintSep, class PrintOptionsT, class Arg>
+    struct is_print_arg_noexcept<PrintSep, PrintOptionsT, Arg, print_arg_kind::value> : ::std::integral_constant<bool,
+        is_sep_noexcept<PrintOptionsT, PrintSep>::value && noexcept(::std::declval<PrintOptionsT>().file << ::std::declval<Arg>())
+    > {};
+
+    template<bool PrintSep, class PrintOptionsT, class Arg>
+    constexpr void print_arg(const PrintOptionsT& opts, Arg&& arg) noexcept(is_print_arg_noexcept<PrintSep, const PrintOptionsT&, Arg>::value) {
+        // Options and `print_nothing` print nothing; their effect on `sep` is already in `PrintSep`
+        if constexpr (print_arg_kind_of<Arg> == print_arg_kind::value) {
+            if constexpr (PrintSep && !is_fwd_same<decltype(opts.sep), print_nothing_t>::value) {
+                opts.file << opts.sep;
+            }
+            opts.file << ::std::forward<Arg>(arg);
+        }
+    }
+
+    template<bool PrintSep, class PrintOptionsT, ::std::size_t... I, class... Args>
+    constexpr void print_args(const PrintOptionsT& opts, ::std::index_sequence<I...> /*unused*/, Args&&... args) noexcept(
+        (true && ... && is_print_arg_noexcept<print_sep_before<PrintSep, Args...>(I), const PrintOptionsT&, Args>::value)
+    ) {
+        (print_arg<print_sep_before<PrintSep, Args...>(I)>(opts, ::std::forward<Args>(args)), ...);
+    }
+
+    template<bool PrintSep, class PrintOptionsT, class... Args>
+    constexpr void print_impl(const PrintOptionsT& opts, Args&&... args)
+    noexcept(noexcept(print_args<PrintSep>(opts, ::std::index_sequence_for<Args...>(), ::std::forward<Args>(args)...)))
+    {
+        print_args<PrintSep>(opts, ::std::index_sequence_for<Args...>(), ::std::forward<Args>(args)...);
+    }
+#else
     template<bool, class PrintOptionsT>
     constexpr constexpr_return_type print_impl(const PrintOptionsT& /*unused*/) noexcept { return static_cast<constexpr_return_type>(0U); }
 
@@ -482,6 +1178,8 @@ namespace printer { namespace detail {
         );
     }
 
+#endif
+
     template<class File, class End>
     constexpr typename ::std::enable_if<!is_fwd_same<End, print_nothing_t>::value, constexpr_return_type>::type
     print_end_impl(File&& f, End&& end) noexcept(noexcept(f << ::std::forward<End>(end))) {
@@ -502,35 +1200,132 @@ namespace printer { namespace detail {
     template<class Opts>
     struct is_end_noexcept<Opts, true> : ::std::true_type {};
 
+    template<class Opts>
+    struct has_prefix : ::std::integral_constant<bool, !is_fwd_same<decltype(::std::declval<Opts>().prefix), print_nothing_t>::value> {};
+
+    template<class Opts, bool has_prefix_ = has_prefix<Opts>::value>
+    struct is_prefix_noexcept : ::std::integral_constant<bool, noexcept(::std::declval<Opts>().file << ::std::declval<decltype(::std::declval<Opts>().prefix)>())> {};
+
+    template<class Opts>
+    struct is_prefix_noexcept<Opts, false> : ::std::true_type {};
+
     template<class Flusher, class Opts, bool can_flush>
     struct is_flush_noexcept : ::std::integral_constant<bool, noexcept(Flusher{}(::std::declval<Opts>().file))> {};
 
     template<class Flusher, class Opts>
     struct is_flush_noexcept<Flusher, Opts, false> : ::std::true_type {};
 
+    // Number of arguments that are actually printed
+    template<class... Args>
+    struct print_value_count : ::std::integral_constant<::std::size_t, 0U> {};
+
+    template<class Arg, class... Args>
+    struct print_value_count<Arg, Args...> : ::std::integral_constant<::std::size_t,
+        (is_fwd_print_opt_value<Arg>::value || is_fwd_same<Arg, print_nothing_t>::value ? 0U : 1U) + print_value_count<Args...>::value
+    > {};
+
+#ifdef PRINT_HAS_PROBES
+    // Prints `prefix`, the arguments and `end`
+    template<class Opts, class... Args>
+    void print_body(const Opts& opts, Args&&... args) {
+        print_end_impl(opts.file, ::std::forward<decltype(opts.prefix)>(opts.prefix));
+        print_impl<has_prefix<const Opts&>::value>(opts, ::std::forward<Args>(args)...);
+        print_end_impl(opts.file, ::std::forward<decltype(opts.end)>(opts.end));
+    }
+
+    // Prints the body, and returns how many bytes were written for the `bytes` probe argument, or -1 if not counted
+    template<class Opts, class... Args>
+    long long print_counted(::std::false_type /*unused*/, const Opts& opts, Args&&... args) {
+        print_body(opts, ::std::forward<Args>(args)...);
+        return -1LL;
+    }
+
+    // For an `std::ostream`, the line is formatted into a buffer with the stream's format flags and locale, then
+    // written with a single `write`. Other threads may be using the stream, so its `std::streambuf` is not touched.
+    template<class Opts, class... Args>
+    long long print_counted(::std::true_type /*unused*/, const Opts& opts, Args&&... args) {
+        ::std::ostream& os = opts.file;
+        if (!os.good()) {
+            print_body(opts, ::std::forward<Args>(args)...);
+            return 0LL;
+        }
+
+        ::std::ostringstream buffer;
+        buffer.imbue(os.getloc());
+        buffer.flags(os.flags());
+        buffer.precision(os.precision());
+        buffer.width(os.width());
+        buffer.fill(os.fill());
+        print_body(
+            print_options<decltype(opts.sep), decltype(opts.end), ::std::ostream&, decltype(opts.prefix)>(
+                ::std::forward<decltype(opts.sep)>(opts.sep), ::std::forward<decltype(opts.end)>(opts.end),
+                buffer, ::std::forward<decltype(opts.prefix)>(opts.prefix), opts.flush
+            ),
+            ::std::forward<Args>(args)...
+        );
+
+        // Keep the effect of manipulators in the arguments
+        if (buffer.flags() != os.flags()) os.flags(buffer.flags());
+        if (buffer.precision() != os.precision()) os.precision(buffer.precision());
+        if (buffer.width() != os.width()) os.width(buffer.width());
+        if (buffer.fill() != os.fill()) os.fill(buffer.fill());
+
+        const ::std::string bytes = buffer.str();
+        os.write(bytes.data(), static_cast<::std::streamsize>(bytes.size()));
+        return os.good() ? static_cast<long long>(bytes.size()) : -1LL;
+    }
+
+    template<class Flusher, class Opts, class... Args>
+    constexpr_return_type print_impl_2(const Opts& opts, Args&&... args) noexcept(
+        is_prefix_noexcept<const Opts&>::value &&
+        noexcept(print_impl<has_prefix<const Opts&>::value>(opts, ::std::forward<Args>(args)...)) &&
+        is_end_noexcept<const Opts&>::value &&
+        is_flush_noexcept<Flusher, const Opts&, print_can_possibly_flush<Args...>::value>::value
+    ) {
+        const ::std::size_t count = print_value_count<Args...>::value;
+        PRINT_PROBE1(entry, count);
+
+        using is_ostream = ::std::is_base_of<::std::ostream, typename ::std::remove_reference<decltype(opts.file)>::type>;
+        const long long bytes = PRINT_PROBE_ENABLED(exit) ?
+            print_counted(is_ostream{}, opts, ::std::forward<Args>(args)...) :
+            print_counted(::std::false_type{}, opts, ::std::forward<Args>(args)...);
+
+        const bool flushed = print_can_possibly_flush<Args...>::value && (print_will_always_flush<Args...>::value || opts.flush);
+        if (flushed) PRINT_PROBE1(flush_entry, count);
+        print_flush<print_will_always_flush<Args...>::value, print_can_possibly_flush<Args...>::value, Flusher>(opts.flush, opts.file);
+        if (flushed) PRINT_PROBE1(flush_exit, count);
+
+        PRINT_PROBE3(exit, count, bytes, static_cast<int>(flushed));
+        return static_cast<constexpr_return_type>(0U);
+    }
+#else
     template<class Flusher, class Opts, class... Args>
     constexpr constexpr_return_type print_impl_2(const Opts& opts, Args&&... args) noexcept(
-        noexcept(print_impl<false>(opts, ::std::forward<Args>(args)...)) &&
+        is_prefix_noexcept<const Opts&>::value &&
+        noexcept(print_impl<has_prefix<const Opts&>::value>(opts, ::std::forward<Args>(args)...)) &&
         is_end_noexcept<const Opts&>::value &&
         is_flush_noexcept<Flusher, const Opts&, print_can_possibly_flush<Args...>::value>::value
     ) {
+        // `prefix` is printed like an extra first argument, so it is followed by `sep`
         return (
-            static_cast<void>(print_impl<false>(opts, ::std::forward<Args>(args)...)),
+            static_cast<void>(print_end_impl(opts.file, ::std::forward<decltype(opts.prefix)>(opts.prefix))),
+            static_cast<void>(print_impl<has_prefix<const Opts&>::value>(opts, ::std::forward<Args>(args)...)),
             static_cast<void>(print_end_impl(opts.file, ::std::forward<decltype(opts.end)>(opts.end))),
             static_cast<void>(print_flush<print_will_always_flush<Args...>::value, print_can_possibly_flush<Args...>::value, Flusher>(opts.flush, opts.file)),
             static_cast<constexpr_return_type>(0U)
         );
     }
+#endif
 
     template<class Flusher, class SepT, class EndT, class... Args>
     constexpr constexpr_return_type print_impl_3(const SepT& default_sep, const EndT& default_end, Args&&... args) noexcept(
         noexcept(print_impl_2<Flusher>(
-            combine_options(print_options<const SepT&, const EndT&, ::std::ostream&>(default_sep, default_end, ::std::cout, false), ::std::forward<Args>(args)...),
+            combine_options(print_options<const SepT&, const EndT&, ::std::ostream&, print_nothing_t>(default_sep, default_end, ::std::cout, print_nothing_t(), false), ::std::forward<Args>(args)...),
             ::std::forward<Args>(args)...
         ))
     ) {
         return static_cast<void>(print_impl_2<Flusher>(
-            combine_options(print_options<const SepT&, const EndT&, ::std::ostream&>(default_sep, default_end, ::std::cout, false), ::std::forward<Args>(args)...),
+            combine_options(print_options<const SepT&, const EndT&, ::std::ostream&, print_nothing_t>(default_sep, default_end, ::std::cout, print_nothing_t(), false), ::std::forward<Args>(args)...),
             ::std::forward<Args>(args)...
         )), static_cast<constexpr_return_type>(0U);
     }
@@ -554,6 +1349,468 @@ namespace printer {
     }
 }  // namespace printer
 
+namespace printer {
+#ifdef PRINT_HAS_FD_READ
+    namespace detail {
+        inline long long fd_read(int fd, char* buf, ::std::size_t size) {
+#ifdef _WIN32
+            return static_cast<long long>(::_read(fd, buf, static_cast<unsigned>(size)));
+#else
+            return static_cast<long long>(::read(fd, buf, size));
+#endif
+        }
+    }  // namespace detail
+
+#endif
+    /**
+     * Buffered input from a `std::istream` (Or a file descriptor, if `PRINT_ENABLE_FD_READ` is defined), for
+     * `printer::read` and `printer::input`.
+     *
+     * Reads `buffer_size` bytes at a time, so once something has been read through a `reader`, the rest of the input
+     * should also be read through it.
+     */
+    class reader {
+    public:
+#ifdef PRINT_HAS_FD_READ
+        explicit reader(int fd, ::std::size_t buffer_size = 1U << 16U) : fd_(fd), buffer_(buffer_size == 0U ? 1U : buffer_size, '\0') {}
+#endif
+        explicit reader(::std::istream& is, ::std::size_t buffer_size = 1U << 16U) : is_(&is), buffer_(buffer_size == 0U ? 1U : buffer_size, '\0') {}
+
+        // The next byte (As an `unsigned char`), or `EOF`.
+        int peek() {
+            return pos_ != end_ || refill() ? static_cast<unsigned char>(buffer_[pos_]) : EOF;
+        }
+
+        void bump() noexcept {
+            ++pos_;
+        }
+
+        bool eof() const noexcept {
+            return eof_;
+        }
+
+    private:
+        bool refill() {
+            pos_ = 0U;
+            end_ = 0U;
+            if (eof_) return false;
+#ifdef PRINT_HAS_FD_READ
+            if (is_ == nullptr) {
+                for (;;) {
+                    const long long count = detail::fd_read(fd_, &buffer_[0], buffer_.size());
+                    if (count > 0) {
+                        end_ = static_cast<::std::size_t>(count);
+                        return true;
+                    }
+                    if (count < 0 && errno == EINTR) continue;
+                    eof_ = true;
+                    return false;
+                }
+            }
+#endif
+            if (is_->tie() != nullptr) is_->tie()->flush();
+            // At most one `underflow()`, so this doesn't wait for a whole buffer from a pipe or terminal
+            ::std::streambuf* buf = is_->rdbuf();
+            ::std::streamsize count = 0;
+            if (!::std::istream::traits_type::eq_int_type(buf->sgetc(), ::std::istream::traits_type::eof())) {
+                const ::std::streamsize available = buf->in_avail();
+                const ::std::streamsize size = static_cast<::std::streamsize>(buffer_.size());
+                count = buf->sgetn(&buffer_[0], available <= 0 ? 1 : available < size ? available : size);
+            }
+            if (count <= 0) {
+                is_->setstate(::std::ios_base::eofbit);
+                eof_ = true;
+                return false;
+            }
+            end_ = static_cast<::std::size_t>(count);
+            return true;
+        }
+
+#ifdef PRINT_HAS_FD_READ
+        int fd_ = -1;
+#endif
+        ::std::istream* is_ = nullptr;
+        ::std::string buffer_;
+        ::std::size_t pos_ = 0U;
+        ::std::size_t end_ = 0U;
+        bool eof_ = false;
+    };
+
+    namespace detail {
+        // Reads straight from the `std::streambuf` of an `std::istream`, skipping the sentry and locale. Like the
+        // sentry, the tied stream (`std::cout` for `std::cin`) is flushed first, once per `read` or `input`.
+        class istream_source {
+        public:
+            explicit istream_source(::std::istream& is) : is_(is), buf_(is.rdbuf()) {
+                if (is.tie() != nullptr) is.tie()->flush();
+            }
+
+            int peek() {
+                const ::std::istream::int_type ch = buf_->sgetc();
+                if (::std::istream::traits_type::eq_int_type(ch, ::std::istream::traits_type::eof())) {
+                    is_.setstate(::std::ios_base::eofbit);
+                    return EOF;
+                }
+                return static_cast<unsigned char>(::std::istream::traits_type::to_char_type(ch));
+            }
+
+            void bump() {
+                buf_->sbumpc();
+            }
+
+            void fail() {
+                is_.setstate(::std::ios_base::failbit);
+            }
+
+        private:
+            ::std::istream& is_;
+            ::std::streambuf* buf_;
+        };
+
+        class reader_source {
+        public:
+            explicit reader_source(reader& r) noexcept : r_(r) {}
+
+            int peek() { return r_.peek(); }
+            void bump() noexcept { r_.bump(); }
+            void fail() noexcept {}
+
+        private:
+            reader& r_;
+        };
+
+        inline istream_source make_read_source(::std::istream& is) { return istream_source(is); }
+        inline reader_source make_read_source(reader& r) noexcept { return reader_source(r); }
+
+        inline bool is_read_space(int ch) noexcept {
+            return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+        }
+
+        // Characters that separate values for `printer::read`: whitespace and the characters in `sep`
+        inline bool is_read_delimiter(int ch, print_nothing_t /*unused*/) noexcept {
+            return is_read_space(ch);
+        }
+
+        inline bool is_read_delimiter(int ch, char sep) noexcept {
+            return is_read_space(ch) || ch == static_cast<unsigned char>(sep);
+        }
+
+        inline bool is_read_delimiter(int ch, const char* sep) noexcept {
+            if (is_read_space(ch)) return true;
+            for (; *sep != '\0'; ++sep) {
+                if (ch == static_cast<unsigned char>(*sep)) return true;
+            }
+            return false;
+        }
+
+        template<class Source, class Sep>
+        int skip_read_delimiters(Source& src, const Sep& sep) {
+            int ch = src.peek();
+            while (ch != EOF && is_read_delimiter(ch, sep)) {
+                src.bump();
+                ch = src.peek();
+            }
+            return ch;
+        }
+
+        // Reads a token into `buf`. Returns false if there was no token, or if it is too long for `buf`.
+        template<class Source, class Sep, ::std::size_t N>
+        bool read_token(Source& src, const Sep& sep, char (&buf)[N], ::std::size_t& size) {
+            int ch = skip_read_delimiters(src, sep);
+            size = 0U;
+            while (ch != EOF && !is_read_delimiter(ch, sep)) {
+                if (size == N - 1U) return false;
+                buf[size++] = static_cast<char>(ch);
+                src.bump();
+                ch = src.peek();
+            }
+            buf[size] = '\0';
+            return size != 0U;
+        }
+
+        template<class T>
+        typename ::std::enable_if<::std::is_unsigned<T>::value, bool>::type parse_integer(const char* first, const char* last, T& value) noexcept {
+            if (first != last && *first == '+') ++first;
+            if (first == last) return false;
+            T result = 0U;
+            for (; first != last; ++first) {
+                const unsigned digit = static_cast<unsigned>(*first) - static_cast<unsigned>('0');
+                if (digit > 9U) return false;
+                if (result > (::std::numeric_limits<T>::max() - digit) / 10U) return false;
+                result = static_cast<T>(result * 10U + digit);
+            }
+            value = result;
+            return true;
+        }
+
+        template<class T>
+        typename ::std::enable_if<::std::is_signed<T>::value, bool>::type parse_integer(const char* first, const char* last, T& value) noexcept {
+            using unsigned_t = typename ::std::make_unsigned<T>::type;
+            const bool negative = first != last && *first == '-';
+            if (negative) {
+                ++first;
+                if (first != last && *first == '+') return false;
+            }
+            unsigned_t magnitude = 0U;
+            if (!parse_integer(first, last, magnitude)) return false;
+            const unsigned_t limit = static_cast<unsigned_t>(::std::numeric_limits<T>::max()) + (negative ? 1U : 0U);
+            if (magnitude > limit) return false;
+            // `0U - magnitude` converted back to `T` is `-magnitude` (Including for the minimum value)
+            value = negative ? static_cast<T>(0U - magnitude) : static_cast<T>(magnitude);
+            return true;
+        }
+
+        template<class T>
+        bool parse_floating(char* first, char* last, T& value) noexcept {
+#ifdef PRINT_HAS_FLOAT_FROM_CHARS
+            if (first != last && *first == '+') ++first;
+            const ::std::from_chars_result result = ::std::from_chars(first, last, value);
+            return result.ec == ::std::errc() && result.ptr == last;
+#else
+            // `strtold` uses the C locale's decimal point, so swap it with '.' (Which `strtold` then rejects if it
+            // isn't the decimal point), so only '.' is accepted whatever the locale.
+            const char decimal_point = *::std::localeconv()->decimal_point;
+            if (decimal_point != '.' && decimal_point != '\0') {
+                for (char* p = first; p != last; ++p) {
+                    if (*p == '.') {
+                        *p = decimal_point;
+                    } else if (*p == decimal_point) {
+                        *p = '.';
+                    }
+                }
+            }
+            // `first` is null terminated by `read_token`
+            char* end = nullptr;
+            const long double result = ::std::strtold(first, &end);
+            if (end != last || first == last) return false;
+            value = static_cast<T>(result);
+            return true;
+#endif
+        }
+
+        template<class Source, class Sep, class T>
+        typename ::std::enable_if<::std::is_integral<T>::value && !::std::is_same<T, bool>::value && !::std::is_same<T, char>::value, bool>::type
+        read_value(Source& src, const Sep& sep, T& value) {
+            char buf[64];
+            ::std::size_t size;
+            return read_token(src, sep, buf, size) && parse_integer(buf, buf + size, value);
+        }
+
+        template<class Source, class Sep, class T>
+        typename ::std::enable_if<::std::is_floating_point<T>::value, bool>::type
+        read_value(Source& src, const Sep& sep, T& value) {
+            char buf[512];
+            ::std::size_t size;
+            return read_token(src, sep, buf, size) && parse_floating(buf, buf + size, value);
+        }
+
+        template<class Source, class Sep>
+        bool read_value(Source& src, const Sep& sep, bool& value) {
+            char buf[8];
+            ::std::size_t size;
+            if (!read_token(src, sep, buf, size)) return false;
+            const ::std::string token(buf, size);
+            if (token == "1" || token == "true") {
+                value = true;
+            } else if (token == "0" || token == "false") {
+                value = false;
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        template<class Source, class Sep>
+        bool read_value(Source& src, const Sep& sep, char& value) {
+            const int ch = skip_read_delimiters(src, sep);
+            if (ch == EOF) return false;
+            value = static_cast<char>(ch);
+            src.bump();
+            return true;
+        }
+
+        template<class Source, class Sep>
+        bool read_value(Source& src, const Sep& sep, ::std::string& value) {
+            int ch = skip_read_delimiters(src, sep);
+            if (ch == EOF) return false;
+            value.clear();
+            while (ch != EOF && !is_read_delimiter(ch, sep)) {
+                value.push_back(static_cast<char>(ch));
+                src.bump();
+                ch = src.peek();
+            }
+            return true;
+        }
+
+        template<class Source, class Sep>
+        ::std::size_t read_impl(Source& /*unused*/, const Sep& /*unused*/) noexcept {
+            return 0U;
+        }
+
+        template<class Source, class Sep, class Arg, class... Args>
+        typename ::std::enable_if<is_fwd_print_opt_value<Arg>::value, ::std::size_t>::type
+        read_impl(Source& src, const Sep& sep, Arg&& /*unused*/, Args&&... args) {
+            return read_impl(src, sep, ::std::forward<Args>(args)...);
+        }
+
+        template<class Source, class Sep, class Arg, class... Args>
+        typename ::std::enable_if<!is_fwd_print_opt_value<Arg>::value, ::std::size_t>::type
+        read_impl(Source& src, const Sep& sep, Arg&& arg, Args&&... args) {
+            if (!read_value(src, sep, arg)) {
+                src.fail();
+                return 0U;
+            }
+            return 1U + read_impl(src, sep, ::std::forward<Args>(args)...);
+        }
+
+        template<class Source>
+        ::std::string input_impl(Source& src) {
+            ::std::string line;
+            int ch = src.peek();
+            if (ch == EOF) src.fail();
+            while (ch != EOF) {
+                src.bump();
+                if (ch == '\n') break;
+                line.push_back(static_cast<char>(ch));
+                ch = src.peek();
+            }
+            return line;
+        }
+
+        template<class SepT>
+        constexpr print_options<const SepT&, const print_nothing_t&, ::std::istream&, print_nothing_t> read_options(const SepT& default_sep, const print_nothing_t& nothing) noexcept {
+            return print_options<const SepT&, const print_nothing_t&, ::std::istream&, print_nothing_t>(default_sep, nothing, ::std::cin, print_nothing_t(), false);
+        }
+    }  // namespace detail
+
+    /**
+     * Reads whitespace separated values from `file` (Default `std::cin`) into each argument, like `std::cin >> a >> b`.
+     * `file` can be a `std::istream` or a `printer::reader`. If `sep` is a character (or a string of characters),
+     * those also separate values. Returns the number of arguments that were read. It stops at the first value that
+     * can't be read, and sets `failbit` on an `std::istream`.
+     *
+     *     int a;
+     *     double b;
+     *     std::string c;
+     *     printer::reader in(std::cin);  // Buffered reads from stdin
+     *     printer::read(a, b, c, file=in);  // Reads "1 2.5 three"
+     *     printer::read(a, b, sep=',', file=in);  // Reads "1,2.5"
+     *
+     * Integers, floating point numbers, `bool` (`0`, `1`, `true` or `false`), `char` (One non-whitespace character)
+     * and `std::string` are supported. Numbers are parsed without the locale (With `std::from_chars` for floating point
+     * numbers if available, otherwise `std::strtold` with '.' as the decimal point whatever the C locale). Not brought
+     * into the global scope, so it doesn't conflict with POSIX `read`.
+     */
+    template<class... Args>
+    ::std::size_t read(Args&&... args) {
+        const print_nothing_t nothing{};
+        const auto opts = detail::combine_options(detail::read_options(nothing, nothing), args...);
+        auto src = detail::make_read_source(opts.file);
+        return detail::read_impl(src, opts.sep, ::std::forward<Args>(args)...);
+    }
+
+    /**
+     * Like Python's `input`: prints the arguments as a prompt (Like `print(args..., end=print_nothing, flush=true)` to
+     * `std::cout`), then reads a line from `file` (Default `std::cin`) and returns it without the newline.
+     * At the end of the input, returns an empty string (And sets `failbit` on an `std::istream`).
+     */
+    template<class... Args>
+    ::std::string input(Args&&... args) {
+        const print_nothing_t nothing{};
+        const char default_sep = ' ';
+        const auto opts = detail::combine_options(detail::read_options(default_sep, nothing), args...);
+        if (detail::print_value_count<Args...>::value != 0U) {
+            detail::print_impl<false>(
+                detail::print_options<decltype(opts.sep), const print_nothing_t&, ::std::ostream&, print_nothing_t>(
+                    ::std::forward<decltype(opts.sep)>(opts.sep), nothing, ::std::cout, print_nothing_t(), false
+                ),
+                ::std::forward<Args>(args)...
+            );
+            ::std::cout.flush();
+        }
+        auto src = detail::make_read_source(opts.file);
+        return detail::input_impl(src);
+    }
+}  // namespace printer
+
+#ifdef PRINT_HAS_COROUTINES
+namespace printer {
+    namespace detail {
+        struct no_flush {
+            template<class T>
+            constexpr void operator()(T&& /*unused*/) const noexcept {}
+        };
+    }  // namespace detail
+
+    /**
+     * Returned by `printer::async_print`. The line is already formatted; awaiting it writes it to the sink, so nothing
+     * is written if it is discarded.
+     */
+    template<class Flusher, class Sink, bool CanFlush>
+    class [[nodiscard]] async_print_awaitable {
+    public:
+        async_print_awaitable(Sink& sink, ::std::string bytes, bool flushing) noexcept : sink_(&sink), bytes_(::std::move(bytes)), flush_(flushing) {}
+
+        bool await_ready() {
+            if (!bytes_.empty()) written_ = sink_->try_write(bytes_.data(), bytes_.size());
+            return written_ == bytes_.size();
+        }
+
+        void await_suspend(::std::coroutine_handle<> handle) {
+            sink_->async_write(bytes_.data() + written_, bytes_.size() - written_, handle);
+        }
+
+        void await_resume() {
+            detail::print_flush<false, CanFlush, Flusher>(flush_, *sink_);
+        }
+
+    private:
+        Sink* sink_;
+        ::std::string bytes_;
+        ::std::size_t written_ = 0U;
+        bool flush_;
+    };
+
+    /**
+     * `co_await printer::async_print(args..., file=sink)` is like `print(args..., file=sink)`, with the same keyword
+     * arguments, except that the coroutine is suspended instead of blocking when `sink` is full.
+     *
+     * The line is formatted into a buffer when `async_print` is called, then `sink` is given the bytes with:
+     *
+     *     std::size_t try_write(const char* data, std::size_t size);  // Write as much as possible without blocking
+     *     void async_write(const char* data, std::size_t size, std::coroutine_handle<> h);  // Write everything, then resume `h`
+     *
+     * `async_write` is only called if `try_write` did not write everything, and `data` is valid until `h` is resumed.
+     * If `flush` is true, the `Flusher` is called on `sink` after everything has been written.
+     */
+    template<class Flusher = printer::print_flusher, class... Args>
+    [[nodiscard]] auto async_print(Args&&... args) {
+        const char default_sep = ' ';
+        const char default_end = '\n';
+        const auto opts = detail::combine_options(
+            detail::print_options<const char&, const char&, ::std::ostream&, print_nothing_t>(default_sep, default_end, ::std::cout, print_nothing_t(), false),
+            args...
+        );
+        static_assert(::std::remove_cvref_t<decltype(opts)>::set_file, "`file` keyword argument must be passed to async_print().");
+
+        ::std::ostringstream buffer;
+        detail::print_impl_2<detail::no_flush>(
+            detail::print_options<decltype(opts.sep), decltype(opts.end), ::std::ostream&, decltype(opts.prefix)>(
+                ::std::forward<decltype(opts.sep)>(opts.sep), ::std::forward<decltype(opts.end)>(opts.end),
+                buffer, ::std::forward<decltype(opts.prefix)>(opts.prefix), false
+            ),
+            ::std::forward<Args>(args)...
+        );
+
+        constexpr bool can_flush = detail::print_can_possibly_flush<Args...>::value;
+        using sink_type = ::std::remove_reference_t<decltype(opts.file)>;
+        return async_print_awaitable<Flusher, sink_type, can_flush>(
+            opts.file, ::std::move(buffer).str(), can_flush && (detail::print_will_always_flush<Args...>::value || opts.flush)
+        );
+    }
+}  // namespace printer
+#endif
+
 #ifdef __clang__
 // Stop ignoring -Wcomma and -Wpadded
 #if __clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 9)
@@ -575,6 +1832,7 @@ namespace printer {
 using printer::sep;  // NOLINT: Bad style to have globals. Which is why it's togglable.
 using printer::end;  // NOLINT
 using printer::file;  // NOLINT
+using printer::prefix;  // NOLINT
 using printer::flush;  // NOLINT
 using printer::print_nothing;  // NOLINT
 using printer::print;  // NOLINT
@@ -0,0 +1,49 @@
+// Compiled by `print_compile_bench` with `-DPRINT_BENCH_N=<N>`; not part of any target itself.
+// Instantiates `print` with `PRINT_BENCH_N` arguments of different types, several times over with different types.
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+
+#include "print.h"
+
+#ifndef PRINT_BENCH_N
+#define PRINT_BENCH_N 16
+#endif
+
+#ifndef PRINT_BENCH_VARIANTS
+#define PRINT_BENCH_VARIANTS 8
+#endif
+
+template<::std::size_t I>
+struct bench_arg {
+    friend ::std::ostream& operator<<(::std::ostream& os, bench_arg /*unused*/) {
+        return os << I;
+    }
+};
+
+// Every fourth argument is a builtin type, so the overloads of `std::ostream::operator<<` are part of it too
+template<::std::size_t I, ::std::size_t Which = I % 4U>
+struct bench_value {
+    static bench_arg<I> get() noexcept { return {}; }
+};
+
+template<::std::size_t I>
+struct bench_value<I, 0U> {
+    static ::std::size_t get() noexcept { return I; }
+};
+
+template<::std::size_t Variant, ::std::size_t... I>
+void bench_print(::std::ostream& os, ::std::index_sequence<I...> /*unused*/) {
+    ::printer::print(bench_value<Variant * PRINT_BENCH_N + I>::get()..., ::printer::file=os);
+}
+
+template<::std::size_t... Variant>
+void bench_all(::std::ostream& os, ::std::index_sequence<Variant...> /*unused*/) {
+    static_cast<void>(::std::initializer_list<int>{ (bench_print<Variant>(os, ::std::make_index_sequence<PRINT_BENCH_N>()), 0)... });
+}
+
+void bench(::std::ostream& os) {
+    bench_all(os, ::std::make_index_sequence<PRINT_BENCH_VARIANTS>());
+}
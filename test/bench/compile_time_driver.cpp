@@ -0,0 +1,77 @@
+// Compiles `compile_time.cpp` with each print engine for N arguments, and reports the compile time and object size.
+// Each configuration is compiled several times, and the minimum and median times are reported.
+//
+// Usage: print_compile_bench [-r RUNS] [N...]  (Defaults to 5 runs and N = 1, 2, 4, 8, 16, 32, 64)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "print.h"
+
+namespace {
+    struct engine {
+        const char* name;
+        const char* flags;
+    };
+
+    const engine engines[] = {
+        { "recursive (C++14)", "-std=c++14" },
+        { "recursive (C++17)", "-std=c++17 -DPRINT_NO_FOLD_ENGINE" },
+        { "fold (C++17)", "-std=c++17" },
+    };
+
+    long long file_size(const ::std::string& path) {
+        ::std::ifstream f(path, ::std::ios::binary | ::std::ios::ate);
+        return f ? static_cast<long long>(f.tellg()) : -1LL;
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    ::std::vector<int> counts;
+    int runs = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (::std::string(argv[i]) == "-r" && i + 1 < argc) {
+            runs = ::std::max(1, ::std::atoi(argv[++i]));
+        } else {
+            counts.push_back(::std::atoi(argv[i]));
+        }
+    }
+    if (counts.empty()) counts = { 1, 2, 4, 8, 16, 32, 64 };
+
+    const ::std::string object = "print_compile_bench.o";
+
+    print("engine", "N", "min ms", "median ms", "object bytes", sep='\t');
+    for (const engine& e : engines) {
+        for (int n : counts) {
+            const ::std::string command = ::std::string(PRINT_BENCH_COMPILER) + " " + e.flags +
+                " -O2 -c -I\"" PRINT_BENCH_INCLUDE "\" -DPRINT_BENCH_N=" + ::std::to_string(n) +
+                " \"" PRINT_BENCH_SOURCE "\" -o " + object;
+
+            ::std::vector<long long> times;
+            for (int run = 0; run < runs; ++run) {
+                const auto start = ::std::chrono::steady_clock::now();
+                const int status = ::std::system(command.c_str());
+                const auto elapsed = ::std::chrono::steady_clock::now() - start;
+
+                if (status != 0) {
+                    print("Failed:", command, file=::std::cerr);
+                    return EXIT_FAILURE;
+                }
+                times.push_back(static_cast<long long>(
+                    ::std::chrono::duration_cast<::std::chrono::milliseconds>(elapsed).count()
+                ));
+            }
+            ::std::sort(times.begin(), times.end());
+            const long long median = times.size() % 2U == 0U ?
+                (times[times.size() / 2U - 1U] + times[times.size() / 2U]) / 2 : times[times.size() / 2U];
+            print(e.name, n, times.front(), median, file_size(object), sep='\t');
+        }
+    }
+    ::std::remove(object.c_str());
+}
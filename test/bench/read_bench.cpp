@@ -0,0 +1,98 @@
+// Compares `printer::read` with `std::cin >>` and `scanf` reading whitespace separated numbers from stdin.
+//
+// Usage: print_read_bench [count]  (Defaults to 1000000 integers and 1000000 doubles)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "print.h"
+
+namespace {
+    const char* const path = "print_read_bench.txt";
+
+    struct totals {
+        long long integers = 0;
+        double doubles = 0.0;
+    };
+
+    void reopen_stdin() {
+        if (::std::freopen(path, "r", stdin) == nullptr) {
+            print("Could not open", path, file=::std::cerr);
+            ::std::exit(EXIT_FAILURE);
+        }
+        ::std::cin.clear();
+    }
+
+    template<class F>
+    void measure(const char* name, long count, F f) {
+        reopen_stdin();
+        const auto start = ::std::chrono::steady_clock::now();
+        const totals t = f(count);
+        const auto elapsed = ::std::chrono::steady_clock::now() - start;
+        print(name, ::std::chrono::duration_cast<::std::chrono::milliseconds>(elapsed).count(), t.integers, t.doubles, sep='\t');
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    const long count = argc > 1 ? ::std::atol(argv[1]) : 1000000L;
+
+    {
+        ::std::ofstream out(path);
+        for (long i = 0; i < count; ++i) {
+            print(i * 7919 % 1000003 - 500000, static_cast<double>(i % 1000) / 8.0, file=out);
+        }
+    }
+
+    print("method", "ms", "integer sum", "double sum", sep='\t');
+
+    measure("scanf", count, [](long n) {
+        totals t;
+        int a;
+        double b;
+        for (long i = 0; i < n && ::std::scanf("%d %lf", &a, &b) == 2; ++i) {
+            t.integers += a;
+            t.doubles += b;
+        }
+        return t;
+    });
+
+    measure("std::cin >>", count, [](long n) {
+        totals t;
+        int a;
+        double b;
+        for (long i = 0; i < n && ::std::cin >> a >> b; ++i) {
+            t.integers += a;
+            t.doubles += b;
+        }
+        return t;
+    });
+
+    measure("printer::read(file=std::cin)", count, [](long n) {
+        totals t;
+        int a;
+        double b;
+        for (long i = 0; i < n && ::printer::read(a, b, file=::std::cin) == 2U; ++i) {
+            t.integers += a;
+            t.doubles += b;
+        }
+        return t;
+    });
+
+    measure("printer::read(file=reader)", count, [](long n) {
+        totals t;
+        int a;
+        double b;
+        ::printer::reader in(::std::cin);
+        for (long i = 0; i < n && ::printer::read(a, b, file=in) == 2U; ++i) {
+            t.integers += a;
+            t.doubles += b;
+        }
+        return t;
+    });
+
+    ::std::remove(path);
+}
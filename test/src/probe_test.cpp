@@ -0,0 +1,176 @@
+// The probes make `print` non-constexpr, so they are tested in their own translation unit
+
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct probe_call {
+    ::std::string name;
+    long long a;
+    long long b;
+    long long c;
+
+    bool operator==(const probe_call& other) const {
+        return name == other.name && a == other.a && b == other.b && c == other.c;
+    }
+};
+
+static ::std::vector<probe_call> probe_calls;
+static ::std::mutex probe_calls_mutex;
+static bool probes_enabled = true;
+
+static void record_probe(const char* name, long long a, long long b, long long c) {
+    const ::std::lock_guard<::std::mutex> lock(probe_calls_mutex);
+    probe_calls.push_back({ name, a, b, c });
+}
+
+#define PRINT_ENABLE_PROBES 1
+#define PRINT_PROBE1(name, a) record_probe(#name, static_cast<long long>(a), 0, 0)
+#define PRINT_PROBE3(name, a, b, c) record_probe(#name, static_cast<long long>(a), static_cast<long long>(b), static_cast<long long>(c))
+#define PRINT_PROBE_ENABLED(name) probes_enabled
+
+#include "print.h"
+#include "gtest/gtest.h"
+
+#ifndef PRINT_HAS_PROBES
+#error "print.h should use the PRINT_PROBE1 and PRINT_PROBE3 macros"
+#endif
+
+::std::ostream& operator<<(::std::ostream& os, const probe_call& call) {
+    return os << call.name << '(' << call.a << ", " << call.b << ", " << call.c << ')';
+}
+
+struct not_an_ostream {
+    ::std::string text;
+
+    template<class T>
+    not_an_ostream& operator<<(const T& value) {
+        ::std::ostringstream ss;
+        ss << value;
+        text += ss.str();
+        return *this;
+    }
+};
+
+TEST(PrintTests, probe_tests) {
+    using ::file;
+    using ::sep;
+    using ::end;
+    using ::flush;
+    using ::prefix;
+
+    ::std::stringstream ss;
+    print(1, "two", 3.5, file=ss);
+    ASSERT_EQ(ss.str(), "1 two 3.5\n");
+    ASSERT_EQ(probe_calls, (::std::vector<probe_call>{
+        { "entry", 3, 0, 0 },
+        { "exit", 3, 10, 0 }
+    }));
+
+    probe_calls.clear();
+    print("a", "b", sep=", ", end="!\n", prefix="> ", file=ss, flush=true);
+    ASSERT_EQ(ss.str(), "1 two 3.5\n> , a, b!\n");
+    ASSERT_EQ(probe_calls, (::std::vector<probe_call>{
+        { "entry", 2, 0, 0 },
+        { "flush_entry", 2, 0, 0 },
+        { "flush_exit", 2, 0, 0 },
+        { "exit", 2, 10, 1 }
+    }));
+
+    // Bytes are only counted for `std::ostream`s, and only while enabled
+    probe_calls.clear();
+    not_an_ostream other;
+    print("abc", file=other);
+    ASSERT_EQ(other.text, "abc\n");
+    probes_enabled = false;
+    print("abc", file=ss);
+    probes_enabled = true;
+    ASSERT_EQ(probe_calls, (::std::vector<probe_call>{
+        { "entry", 1, 0, 0 },
+        { "exit", 1, -1, 0 },
+        { "entry", 1, 0, 0 },
+        { "exit", 1, -1, 0 }
+    }));
+
+    // The stream's buffer and state are restored
+    probe_calls.clear();
+    ::std::streambuf* buf = ss.rdbuf();
+    ss.setstate(::std::ios_base::failbit);
+    print("ignored", file=ss);
+    ASSERT_EQ(ss.rdbuf(), buf);
+    ASSERT_TRUE(ss.fail());
+    ss.clear();
+    print(file=ss);
+    ASSERT_EQ(ss.rdbuf(), buf);
+    ASSERT_TRUE(ss.good());
+    ASSERT_EQ(probe_calls, (::std::vector<probe_call>{
+        { "entry", 1, 0, 0 },
+        { "exit", 1, 0, 0 },
+        { "entry", 0, 0, 0 },
+        { "exit", 0, 1, 0 }
+    }));
+
+    // Manipulators in the arguments still apply to the stream, the same as when not traced
+    ::std::string untraced;
+    for (bool enabled : { false, true }) {
+        probes_enabled = enabled;
+        ::std::stringstream().swap(ss);
+        print(::std::hex, 255, ::std::setw(4), ::std::setfill('0'), file=ss);
+        ss << 16 << ' ' << ::std::setw(3) << 1;
+        if (!enabled) untraced = ss.str();
+    }
+    ASSERT_EQ(ss.str(), untraced);
+    ASSERT_EQ(untraced.substr(untraced.size() - 6U), "10 001");
+}
+
+// A `std::streambuf` that can be written to from multiple threads
+class locked_streambuf : public ::std::stringbuf {
+protected:
+    int_type overflow(int_type ch) override {
+        const ::std::lock_guard<::std::recursive_mutex> lock(mutex_);
+        return ::std::stringbuf::overflow(ch);
+    }
+
+    ::std::streamsize xsputn(const char* s, ::std::streamsize count) override {
+        const ::std::lock_guard<::std::recursive_mutex> lock(mutex_);
+        return ::std::stringbuf::xsputn(s, count);
+    }
+
+private:
+    ::std::recursive_mutex mutex_;
+};
+
+TEST(PrintTests, probe_threads_tests) {
+    using ::file;
+
+    probe_calls.clear();
+    locked_streambuf buf;
+    ::std::ostream shared(&buf);
+    ::std::vector<::std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&shared, t] {
+            for (int i = 0; i < 1000; ++i) print("thread", t, "line", i, file=shared);
+        });
+    }
+    for (::std::thread& thread : threads) thread.join();
+
+    // Each line is written at once, so lines are not interleaved
+    ::std::istringstream lines(buf.str());
+    ::std::string line;
+    long long total = 0;
+    int count = 0;
+    while (::std::getline(lines, line)) {
+        ASSERT_EQ(line.compare(0U, 7U, "thread "), 0) << line;
+        ASSERT_NE(line.find(" line "), ::std::string::npos) << line;
+        ++count;
+    }
+    ASSERT_EQ(count, 8 * 1000);
+    for (const probe_call& call : probe_calls) {
+        if (call.name == "exit") total += call.b;
+    }
+    ASSERT_EQ(total, static_cast<long long>(buf.str().size()));
+    ASSERT_EQ(probe_calls.size(), 2U * 8U * 1000U);
+}
@@ -1,9 +1,28 @@
+#include <clocale>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <utility>
 
 #include "print.h"
 #include "gtest/gtest.h"
 
+#if __cplusplus >= 201703L && !defined(PRINT_NO_FOLD_ENGINE) && !defined(PRINT_FOLD_ENGINE)
+#error "print.h should use the fold expression engine in C++17"
+#endif
+
+#if defined(PRINT_HAS_COROUTINES) && __has_include(<unistd.h>) && __has_include(<poll.h>)
+#define PRINT_TEST_ASYNC 1
+#include <cerrno>
+#include <exception>
+#include <functional>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 class PrintTest : public ::testing::Test {
 protected:
     ~PrintTest() override = default;
@@ -120,6 +139,10 @@ TEST_F(PrintTest, other_tests) {
     print("Hello,", print_nothing, " ", print_nothing, "world!", sep="print_nothing didn't work", file=*this);
     ASSERT_EQ(get_string(), hello);
 
+    reset();
+    print("Hello,", print_nothing, sep="print_nothing didn't work", " world!", file=*this);
+    ASSERT_EQ(get_string(), hello);
+
     reset();
     print(end="Hello,", file=*this);
     print("", "world!", file=*this);
@@ -166,6 +189,444 @@ TEST_F(PrintTest, other_tests) {
     ASSERT_EQ(get_string(), hello);
 }
 
+TEST_F(PrintTest, prefix_tests) {
+    using ::print;
+    using ::file;
+    using ::end;
+    using ::sep;
+    using ::prefix;
+    using ::print_nothing;
+    using ::raw_print;
+
+    print("world!", prefix="Hello,", file=*this);
+    ASSERT_EQ(get_string(), "Hello, world!\n");
+
+    reset();
+    print(prefix="Hello, world!", file=*this);
+    ASSERT_EQ(get_string(), "Hello, world!\n");
+
+    reset();
+    print(prefix="Hello, ", print_nothing, "world!", file=*this);
+    ASSERT_EQ(get_string(), "Hello, world!\n");
+
+    reset();
+    raw_print("world!\n", prefix="Hello, ", file=*this);
+    ASSERT_EQ(get_string(), "Hello, world!\n");
+
+    reset();
+    print("a", "b", prefix=print_nothing, sep="+", file=*this);
+    ASSERT_EQ(get_string(), "a+b\n");
+}
+
+TEST(PrintTests, timestamp_tests) {
+    ::std::string text = ::printer::timestamp("%Y-%m-%d %H:%M:%S.%f", true).str();
+    ASSERT_EQ(text.size(), 26u);
+    ASSERT_EQ(text[4], '-');
+    ASSERT_EQ(text[19], '.');
+    ASSERT_EQ(text.find_first_not_of("0123456789", 20), ::std::string::npos);
+
+    text = ::printer::timestamp("%3f|%9f|%%f|%1f", true).str();
+    ASSERT_EQ(text.size(), 3u + 1u + 9u + 3u + 1u + 1u);
+    ASSERT_EQ(text.find_first_not_of("0123456789"), 3u);
+    ASSERT_EQ(text.find_first_not_of("0123456789", 4u), 13u);
+    ASSERT_EQ(text.substr(3u, 1u) + text.substr(13u, 4u), "||%f|");
+    ASSERT_EQ(text.substr(0u, 3u), text.substr(4u, 3u));
+    ASSERT_EQ(text.substr(0u, 1u), text.substr(17u));
+
+    // Alternating formats on one thread
+    for (int i = 0; i < 3; ++i) {
+        text = ::printer::timestamp("%Y %3f %H:%M:%S.%6f", true).str();
+        ASSERT_EQ(text.size(), 4u + 1u + 3u + 1u + 8u + 1u + 6u);
+        ASSERT_EQ(text.substr(5u, 3u), text.substr(18u, 3u));
+        ASSERT_EQ(text.find('%'), ::std::string::npos);
+        ASSERT_EQ(::printer::timestamp("%H:%M", true).str().size(), 5u);
+    }
+    ASSERT_EQ(::printer::timestamp("%f%f%f%f%f%f%f%f%f", true).str().substr(48u), "%f");
+    ASSERT_EQ(::printer::timestamp("%%f", true).str(), "%f");
+    ASSERT_EQ(::printer::timestamp("", true).str(), "");
+    ASSERT_EQ(::printer::timestamp("no time", false).str(), "no time");
+
+    ::std::stringstream ss;
+    ::printer::print("message", ::printer::prefix=::printer::timestamp("[%H:%M]"), ::printer::file=ss);
+    text = ss.str();
+    ASSERT_EQ(text.size(), 16u);
+    ASSERT_EQ(text.substr(7u), " message\n");
+}
+
+TEST(PrintTests, dedup_sink_tests) {
+    using ::print;
+    using ::file;
+    using ::end;
+    using ::flush;
+
+    ::std::stringstream ss;
+    {
+        ::printer::dedup_sink sink(ss, ::std::chrono::hours(1));
+        print("a", 1, file=sink);
+        print("a", 1, file=sink);
+        print("a", 1, file=sink, flush);
+        ASSERT_EQ(ss.str(), "a 1\n");
+
+        print("b", file=sink);
+        ASSERT_EQ(ss.str(), "a 1\nlast line repeated 2 times\nb\n");
+
+        print("a", file=sink, end);
+        print(" 1", file=sink);
+        print("b", file=sink);
+        print("c", file=sink, end);
+        ASSERT_EQ(ss.str(), "a 1\nlast line repeated 2 times\nb\na 1\nb\n");
+    }
+    ASSERT_EQ(ss.str(), "a 1\nlast line repeated 2 times\nb\na 1\nb\nc");
+
+    ::std::stringstream().swap(ss);
+    {
+        ::printer::dedup_sink sink(ss, ::std::chrono::seconds(0));
+        print("a", file=sink);
+        print("a", file=sink);
+        print("a", file=sink);
+        ASSERT_EQ(ss.str(), "a\nlast line repeated 2 times\n");
+        print("a", file=sink, flush);
+        ASSERT_EQ(ss.str(), "a\nlast line repeated 2 times\nlast line repeated 1 time\n");
+    }
+    ASSERT_EQ(ss.str(), "a\nlast line repeated 2 times\nlast line repeated 1 time\n");
+}
+
+TEST_F(PrintTest, tee_tests) {
+    using ::print;
+    using ::file;
+    using ::end;
+    using ::flush;
+
+    ::std::stringstream ss;
+    print("Hello,", "world!", file=::printer::tee(*this, ss));
+    ASSERT_EQ(get_string(), "Hello, world!\n");
+    ASSERT_EQ(ss.str(), "Hello, world!\n");
+
+    reset();
+    ::std::stringstream().swap(ss);
+    print("Hello,", "world!", file=::printer::tee(*this, ss), flush);
+    ASSERT_EQ(get_string(), "Hello, world!\n" + flush_string());
+    ASSERT_EQ(ss.str(), "Hello, world!\n");
+
+    reset();
+    print(file=::printer::tee(::printer::never_flush(*this)), flush);
+    print(file=::printer::tee(::printer::always_flush(*this)));
+    ASSERT_EQ(get_string(), "\n\n" + flush_string());
+
+    reset();
+    {
+        auto both = ::printer::tee(*this, ss);
+        print("a", file=both, end);
+        print("b", file=both);
+        ASSERT_EQ(get_string(), "");
+    }
+    ASSERT_EQ(get_string(), "ab\n");
+
+    // Destinations without `flush()` are written to but not flushed
+    reset();
+    ::std::string text;
+    struct append_only {
+        ::std::string& out;
+        append_only& operator<<(const ::std::string& s) { out += s; return *this; }
+    } appender{text};
+    print("Hello,", "world!", file=::printer::tee(appender, ::printer::always_flush(appender), *this), flush);
+    ASSERT_EQ(text, "Hello, world!\nHello, world!\n");
+    ASSERT_EQ(get_string(), "Hello, world!\n" + flush_string());
+
+    // A destination that throws doesn't stop the others, or terminate
+    reset();
+    struct throwing {
+        throwing& operator<<(const ::std::string& /*unused*/) { throw ::std::runtime_error("write failed"); }
+    } thrower;
+    print("a", file=::printer::tee(thrower, *this));
+    ASSERT_EQ(get_string(), "a\n");
+    auto both = ::printer::tee(*this, thrower);
+    print("b", file=both, flush);
+    ASSERT_TRUE(both.bad());
+    ASSERT_EQ(get_string(), "a\nb\n" + flush_string());
+}
+
+TEST(PrintTests, read_tests) {
+    using ::file;
+    using ::sep;
+
+    int a = 0;
+    unsigned long long b = 0U;
+    double c = 0.0;
+    ::std::string d;
+    char e = '\0';
+    bool f = false;
+
+    ::std::stringstream ss("  -12\n18446744073709551615 2.5e-1 hello\tx true");
+    ASSERT_EQ(::printer::read(a, b, c, d, e, f, file=ss), 6u);
+    ASSERT_EQ(a, -12);
+    ASSERT_EQ(b, ::std::numeric_limits<unsigned long long>::max());
+    ASSERT_EQ(c, 0.25);
+    ASSERT_EQ(d, "hello");
+    ASSERT_EQ(e, 'x');
+    ASSERT_TRUE(f);
+    ASSERT_FALSE(ss.fail());
+    ASSERT_EQ(::printer::read(a, file=ss), 0u);
+    ASSERT_TRUE(ss.fail());
+    ASSERT_TRUE(ss.eof());
+
+    ::std::stringstream csv("1,2, 3;+4");
+    int values[4] = {};
+    ASSERT_EQ(::printer::read(values[0], values[1], values[2], values[3], sep=",;", file=csv), 4u);
+    ASSERT_EQ(values[0] + values[1] + values[2] + values[3], 10);
+
+    ::std::stringstream bad("-2147483648 2147483648 x");
+    ASSERT_EQ(::printer::read(a, a, file=bad), 1u);
+    ASSERT_EQ(a, -2147483647 - 1);
+    ASSERT_TRUE(bad.fail());
+
+    ::std::stringstream unsigned_bad("-1");
+    ASSERT_EQ(::printer::read(b, file=unsigned_bad), 0u);
+
+    // Small buffer so values cross refills
+    ::std::stringstream many;
+    for (int i = 0; i < 1000; ++i) many << i << ' ' << i << ".5\n";
+    ::printer::reader in(many, 7U);
+    long long total = 0;
+    double fractions = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(::printer::read(a, c, file=in), 2u);
+        total += a;
+        fractions += c - a;
+    }
+    ASSERT_EQ(total, 999 * 1000 / 2);
+    ASSERT_EQ(fractions, 500.0);
+    ASSERT_EQ(::printer::read(a, file=in), 0u);
+    ASSERT_TRUE(in.eof());
+
+    // Only '.' is a decimal point, whatever the C locale (If a locale with a ',' decimal point is installed)
+    const ::std::string old_locale = ::std::setlocale(LC_NUMERIC, nullptr);
+    if (::std::setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr) {
+        ::std::stringstream decimals("2.5 2,5");
+        ASSERT_EQ(::printer::read(c, c, file=decimals), 1u);
+        ASSERT_EQ(c, 2.5);
+        static_cast<void>(::std::setlocale(LC_NUMERIC, old_locale.c_str()));
+    }
+
+    // Like a pipe, only gives a few bytes at a time. A value can be read once it has arrived.
+    struct chunked_streambuf : ::std::streambuf {
+        ::std::string data;
+        ::std::size_t pos = 0U;
+        int underflows = 0;
+
+        explicit chunked_streambuf(::std::string data_) : data(::std::move(data_)) {}
+
+        int_type underflow() override {
+            ++underflows;
+            if (pos == data.size()) return traits_type::eof();
+            const ::std::size_t size = data.size() - pos < 3U ? data.size() - pos : 3U;
+            setg(&data[pos], &data[pos], &data[pos] + size);
+            pos += size;
+            return traits_type::to_int_type(data[pos - size]);
+        }
+    } chunks("12 34 56\n");
+    ::std::istream chunked(&chunks);
+    ::printer::reader chunked_in(chunked);
+    ASSERT_EQ(::printer::read(a, file=chunked_in), 1u);
+    ASSERT_EQ(a, 12);
+    ASSERT_EQ(chunks.underflows, 1);
+    ASSERT_EQ(::printer::read(a, a, file=chunked_in), 2u);
+    ASSERT_EQ(a, 56);
+    ASSERT_EQ(chunks.underflows, 3);
+
+    // The tied stream is flushed once per call
+    struct sync_counter : ::std::stringbuf {
+        int syncs = 0;
+        int sync() override { ++syncs; return 0; }
+    } counter;
+    ::std::ostream tied(&counter);
+    ::std::stringstream prompted("1 2\nline");
+    prompted.tie(&tied);
+    ASSERT_EQ(::printer::read(a, a, file=prompted), 2u);
+    ASSERT_EQ(counter.syncs, 1);
+    ASSERT_EQ(::printer::input(file=prompted), "");
+    ASSERT_EQ(counter.syncs, 2);
+}
+
+TEST_F(PrintStdout, input_tests) {
+    using ::file;
+    using ::sep;
+
+    ::std::stringstream ss("first line\r\n\nlast");
+    ASSERT_EQ(::printer::input("Enter", "something:", file=ss), "first line\r");
+    ASSERT_EQ(get_string(), "Enter something:");
+    ASSERT_EQ(::printer::input(file=ss), "");
+    ASSERT_EQ(::printer::input("a", "b", sep="", file=ss), "last");
+    ASSERT_EQ(get_string(), "Enter something:ab");
+    ASSERT_FALSE(ss.fail());
+    ASSERT_EQ(::printer::input(file=ss), "");
+    ASSERT_TRUE(ss.fail());
+}
+
+#ifdef PRINT_TEST_ASYNC
+// Single threaded executor: runs callbacks when file descriptors are ready
+class poll_executor {
+public:
+    void when_ready(int fd, short events, ::std::function<void()> callback) {
+        waiting.push_back({ fd, events, ::std::move(callback) });
+    }
+
+    auto readable(int fd) {
+        struct awaitable {
+            poll_executor& executor;
+            int fd;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(::std::coroutine_handle<> h) { executor.when_ready(fd, POLLIN, [h] { h.resume(); }); }
+            void await_resume() const noexcept {}
+        };
+        return awaitable{ *this, fd };
+    }
+
+    void run() {
+        while (!waiting.empty()) {
+            ::std::vector<pollfd> fds;
+            for (const auto& w : waiting) fds.push_back({ w.fd, w.events, 0 });
+            ASSERT_GT(::poll(fds.data(), fds.size(), 1000), 0);
+
+            ::std::vector<wait> ready;
+            ::std::vector<wait> still_waiting;
+            for (::std::size_t i = 0; i < fds.size(); ++i) {
+                (fds[i].revents != 0 ? ready : still_waiting).push_back(::std::move(waiting[i]));
+            }
+            waiting = ::std::move(still_waiting);
+            for (auto& w : ready) w.callback();
+        }
+    }
+
+private:
+    struct wait {
+        int fd;
+        short events;
+        ::std::function<void()> callback;
+    };
+
+    ::std::vector<wait> waiting;
+};
+
+// Sink for `printer::async_print` writing to a non-blocking pipe
+class pipe_sink {
+public:
+    pipe_sink(poll_executor& executor_, int fd_) : executor(executor_), fd(fd_) {}
+
+    ::std::size_t try_write(const char* data, ::std::size_t size) {
+        const ::ssize_t written = ::write(fd, data, size);
+        return written < 0 ? 0U : static_cast<::std::size_t>(written);
+    }
+
+    void async_write(const char* data, ::std::size_t size, ::std::coroutine_handle<> h) {
+        ++suspensions;
+        write_when_ready(data, size, h);
+    }
+
+    void flush() { ++flushes; }
+
+    void write_when_ready(const char* data, ::std::size_t size, ::std::coroutine_handle<> h) {
+        executor.when_ready(fd, POLLOUT, [this, data, size, h] {
+            const ::std::size_t written = try_write(data, size);
+            if (written == size) {
+                h.resume();
+            } else {
+                write_when_ready(data + written, size - written, h);
+            }
+        });
+    }
+
+    poll_executor& executor;
+    int fd;
+    int suspensions = 0;
+    int flushes = 0;
+};
+
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() noexcept { return {}; }
+        ::std::suspend_never initial_suspend() noexcept { return {}; }
+        ::std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { ::std::terminate(); }
+    };
+};
+
+detached_task async_writer(pipe_sink& sink, const ::std::string& line, int count) {
+    using ::file;
+    using ::sep;
+    using ::flush;
+
+    for (int i = 0; i < count; ++i) {
+        co_await ::printer::async_print(i, line, file=sink, sep=':', flush=(i % 2 == 0));
+    }
+    ::close(sink.fd);
+}
+
+detached_task async_reader(poll_executor& executor, int fd, ::std::string& out) {
+    char buf[4096];
+    for (;;) {
+        co_await executor.readable(fd);
+        const ::ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n == 0) break;
+        if (n > 0) out.append(buf, static_cast<::std::size_t>(n));
+    }
+    ::close(fd);
+}
+
+struct string_sink {
+    ::std::size_t try_write(const char* data, ::std::size_t size) {
+        str.append(data, size);
+        return size;
+    }
+
+    void async_write(const char* /*unused*/, ::std::size_t /*unused*/, ::std::coroutine_handle<> /*unused*/) {
+        FAIL() << "Should not suspend if everything was written";
+    }
+
+    ::std::string str;
+};
+
+detached_task async_string_writer(string_sink& sink) {
+    using ::file;
+    using ::sep;
+    using ::end;
+    using ::prefix;
+    using ::print_nothing;
+
+    co_await ::printer::async_print("Hello,", "world!", file=sink);
+    co_await ::printer::async_print("a", print_nothing, "b", sep="+", end=";", prefix='>', file=sink);
+    co_await ::printer::async_print(file=sink, end);
+}
+
+TEST(PrintTests, async_print_tests) {
+    string_sink strings;
+    async_string_writer(strings);
+    ASSERT_EQ(strings.str, "Hello, world!\n>+ab;");
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+    poll_executor executor;
+    pipe_sink sink(executor, fds[1]);
+    const ::std::string line(10000U, 'x');
+    const int count = 64;
+    ::std::string out;
+
+    async_writer(sink, line, count);
+    async_reader(executor, fds[0], out);
+    executor.run();
+
+    ::std::string expected;
+    for (int i = 0; i < count; ++i) expected += ::std::to_string(i) + ':' + line + '\n';
+    ASSERT_EQ(out, expected);
+    ASSERT_GT(sink.suspensions, 0);
+    ASSERT_EQ(sink.flushes, count / 2);
+}
+#endif
+
 struct void_stream_t {
     template<class T>
     constexpr void operator<<(T&&) const noexcept { /* Do nothing */ }